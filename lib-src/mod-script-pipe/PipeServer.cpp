@@ -111,6 +111,7 @@ void PipeServer()
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
 
@@ -118,6 +119,10 @@ const char fifotmpl[] = "/tmp/audacity_script_pipe.%s.%d";
 
 const int nBuff = 1024;
 
+// Responses can be large (sample data, track info), so they are copied
+// out in big pieces; the fifo itself is buffered by stdio.
+const int nResponseBuff = 65536;
+
 extern "C" int DoSrv( char * pIn );
 extern "C" int DoSrvMore( char * pOut, int nMax );
 
@@ -126,7 +131,9 @@ void PipeServer()
    FILE *fromFifo = NULL;
    FILE *toFifo = NULL;
    int rc;
-   char buf[nBuff];
+   char *line = NULL;
+   size_t lineCapacity = 0;
+   static char buf[nResponseBuff];
    char toFifoName[nBuff];
    char fromFifoName[nBuff];
 
@@ -164,36 +171,42 @@ void PipeServer()
       return;
    }
 
-   while (fgets(buf, sizeof(buf), toFifo) != NULL)
+   // Commands are read whole, however long they are.  A script need not
+   // wait for each response: it may write several commands, which are
+   // answered in order.
+   ssize_t len;
+   while ((len = getline(&line, &lineCapacity, toFifo)) != -1)
    {
-      int len = strlen(buf);
       if (len <= 1)
       {
          continue;
       }
 
-      buf[len - 1] = '\0';
+      if (line[len - 1] == '\n')
+         line[len - 1] = '\0';
 
-      printf("Server received %s\n", buf);
-      DoSrv(buf);
+      printf("Server received %s\n", line);
+      DoSrv(line);
 
       while (true)
       {
-         len = DoSrvMore(buf, nBuff);
-         if (len <= 1)
+         int nWritten = DoSrvMore(buf, nResponseBuff);
+         if (nWritten <= 1)
          {
             break;
          }
-         printf("Server sending %s",buf);
 
-         // len - 1 because we do not send the null character
-         fwrite(buf, 1, len - 1, fromFifo);
+         // nWritten - 1 because we do not send the null character
+         fwrite(buf, 1, nWritten - 1, fromFifo);
       }
+
       fflush(fromFifo);
    }
 
    printf("Read failed on fifo, quitting\n");
 
+   free(line);
+
    if (toFifo != NULL)
       fclose(toFifo);
 
@@ -14,6 +14,7 @@
 // security risk.  Use at your own risk.
 
 #include <wx/wx.h>
+#include <string>
 #include "ScripterCallback.h"
 //#include "../lib_widget_extra/ShuttleGuiBase.h"
 #include "../../src/Audacity.h"
@@ -145,13 +146,13 @@ int DLL_API RegScriptServerFunc( tpExecScriptServerFunc pFn )
 }
 
 
-wxString Str2;
-wxArrayString aStr;
-unsigned int currentLine;
-size_t currentPosition;
+// The response to the last command, already converted to UTF-8, and how
+// much of it DoSrvMore has handed out so far.
+static std::string response;
+static size_t responseSent;
 
-// Send the received command to Audacity and build an array of response lines.
-// The response lines can be retrieved by calling DoSrvMore repeatedly.
+// Send the received command to Audacity and prepare the response.
+// The response can be retrieved by calling DoSrvMore repeatedly.
 int DoSrv(char *pIn)
 {
    // Interpret string as unicode.
@@ -161,72 +162,43 @@ int DoSrv(char *pIn)
    wxString Str1(pIn, wxConvUTF8); 
    Str1.Replace( wxT("\r"), wxT(""));
    Str1.Replace( wxT("\n"), wxT(""));
-   Str2 = wxEmptyString;
+   wxString Str2;
    (*pScriptServerFn)( &Str1 , &Str2);
 
    Str2 += wxT('\n');
-   size_t outputLength = Str2.Length();
-   aStr.Clear();
-   size_t iStart = 0;
-   size_t i;
-   for(i = 0; i < outputLength; ++i)
-   {
-      if( Str2[i] == wxT('\n') )
-      {
-         aStr.Add( Str2.Mid( iStart, i-iStart) + wxT("\n") );
-         iStart = i+1;
-      }
-   }
 
-   currentLine     = 0;
-   currentPosition = 0;
+   // Convert the whole response once, so that DoSrvMore only copies bytes.
+   // Large responses (such as sample values) used to be re-converted a
+   // chunk at a time, and chunks were counted in characters, not bytes.
+   const wxScopedCharBuffer utf8 = Str2.utf8_str();
+   response.assign(utf8.data(), utf8.length());
+   responseSent = 0;
 
    return 1;
 }
 
 size_t smin(size_t a, size_t b) { return a < b ? a : b; }
 
-// Write up to nMax characters of the prepared (by DoSrv) response lines.
-// Returns the number of characters sent, including null.
+// Write up to nMax - 1 bytes of the prepared (by DoSrv) response, and a null.
+// Returns the number of bytes written, including null.
 // Zero returned if and only if there's nothing else to send.
 int DoSrvMore(char *pOut, size_t nMax)
 {
-   wxASSERT(currentLine >= 0);
-   wxASSERT(currentPosition >= 0);
+   wxASSERT(responseSent <= response.size());
 
-   size_t totalLines = aStr.GetCount();
-   while (currentLine < totalLines)
-   {
-      wxString lineString    = aStr[currentLine];
-      size_t lineLength      = lineString.Length();
-      size_t charsLeftInLine = lineLength - currentPosition;
+   size_t bytesToWrite = smin(response.size() - responseSent, nMax - 1);
+   if (bytesToWrite == 0)
+      return 0;
 
-      wxASSERT(charsLeftInLine >= 0);
+   memcpy(pOut, response.data() + responseSent, bytesToWrite);
+   pOut[bytesToWrite] = '\0';
+   responseSent += bytesToWrite;
 
-      if (charsLeftInLine == 0)
-      {
-         // Move to next line
-         ++currentLine;
-         currentPosition = 0;
-      }
-      else
-      {
-         // Write as much of the rest of the line as will fit in the buffer
-         size_t charsToWrite = smin(charsLeftInLine, nMax - 1);
-         memcpy(pOut, 
-                lineString.Mid(currentPosition, 
-                               currentPosition + charsToWrite).mb_str(), 
-                charsToWrite);
-         pOut[charsToWrite] = '\0';
-         currentPosition    += charsToWrite;
-         // Need to cast to prevent compiler warnings
-         int charsWritten = static_cast<int>(charsToWrite + 1);
-         // (Check cast was safe)
-         wxASSERT(static_cast<size_t>(charsWritten) == charsToWrite + 1);
-         return charsWritten;
-      }
-   }
-   return 0;
+   // Need to cast to prevent compiler warnings
+   int bytesWritten = static_cast<int>(bytesToWrite + 1);
+   // (Check cast was safe)
+   wxASSERT(static_cast<size_t>(bytesWritten) == bytesToWrite + 1);
+   return bytesWritten;
 }
 
 } // End extern "C"
@@ -3441,6 +3441,27 @@ void Alg_iterator::begin_seq(Alg_seq_ptr s, void *cookie, double offset)
 }
 
 
+void Alg_iterator::begin_seq(Alg_seq_ptr s, void *cookie, double offset,
+                             double start_time)
+{
+    int i;
+    for (i = 0; i < s->track_list.length(); i++) {
+        Alg_track &events = s->track_list[i];
+        // events are in time order: find the first at or after start_time
+        long lo = 0;
+        long hi = events.length();
+        while (lo < hi) {
+            long mid = lo + (hi - lo) / 2;
+            if (events[mid]->time + offset < start_time) lo = mid + 1;
+            else hi = mid;
+        }
+        if (lo < events.length()) {
+            insert(&events, lo, true, cookie, offset);
+        }
+    }
+}
+
+
 Alg_event_ptr Alg_iterator::next(bool *note_on, void **cookie_ptr, 
                                  double *offset_ptr, double end_time)
     // return the next event in time from any track
@@ -968,6 +968,12 @@ public:
     // sequence to be included in the iteration unless you call begin()
     // (see below).
     void begin_seq(Alg_seq_ptr s, void *cookie = NULL, double offset = 0.0);
+    // Like begin_seq(), but iteration over s begins with the first event
+    // at or after start_time (after adding offset). Each track is searched
+    // rather than stepped through, so starting late in a long sequence
+    // costs little.
+    void begin_seq(Alg_seq_ptr s, void *cookie, double offset,
+                   double start_time);
     ~Alg_iterator();
     // Prepare to enumerate events in order. If note_off_flag is true, then
     // iteration_next will merge note-off events into the sequence. If you
@@ -64,6 +64,7 @@ It handles initialization and termination by subclassing wxApp.
 #include "AboutDialog.h"
 #include "AColor.h"
 #include "AudioIO.h"
+#include "BatchCommands.h"
 #include "Benchmark.h"
 #include "DirManager.h"
 #include "commands/CommandHandler.h"
@@ -88,6 +89,7 @@ It handles initialization and termination by subclassing wxApp.
 #include "FileNames.h"
 #include "AutoRecovery.h"
 #include "SplashDialog.h"
+#include "StartupProfiler.h"
 #include "FFT.h"
 #include "BlockFile.h"
 #include "ondemand/ODManager.h"
@@ -1411,7 +1413,10 @@ bool AudacityApp::OnInit()
 #endif
 
    // Initialize preferences and language
-   InitPreferences();
+   {
+      StartupProfiler::Phase phase{ wxT("Preferences and language") };
+      InitPreferences();
+   }
 
 #if defined(__WXMSW__) && !defined(__WXUNIVERSAL__) && !defined(__CYGWIN__)
    this->AssociateFileTypes();
@@ -1421,16 +1426,22 @@ bool AudacityApp::OnInit()
    mRecentFiles = std::make_unique<FileHistory>(ID_RECENT_LAST - ID_RECENT_FIRST + 1, ID_RECENT_CLEAR);
    mRecentFiles->Load(*gPrefs, wxT("RecentFiles"));
 
-   theTheme.EnsureInitialised();
+   {
+      StartupProfiler::Phase phase{ wxT("Theme") };
+      theTheme.EnsureInitialised();
 
-   // AColor depends on theTheme.
-   AColor::Init();
+      // AColor depends on theTheme.
+      AColor::Init();
+   }
 
    // Init DirManager, which initializes the temp directory
    // If this fails, we must exit the program.
-   if (!InitTempDir()) {
-      FinishPreferences();
-      return false;
+   {
+      StartupProfiler::Phase phase{ wxT("Temporary directory") };
+      if (!InitTempDir()) {
+         FinishPreferences();
+         return false;
+      }
    }
 
    //<<<< Try to avoid dialogs before this point.
@@ -1442,10 +1453,16 @@ bool AudacityApp::OnInit()
    InitCommandHandler();
 
    // Initialize the PluginManager
-   PluginManager::Get().Initialize();
+   {
+      StartupProfiler::Phase phase{ wxT("Plugin manager") };
+      PluginManager::Get().Initialize();
+   }
 
    // Initialize the ModuleManager, including loading found modules
-   ModuleManager::Get().Initialize(*mCmdHandler);
+   {
+      StartupProfiler::Phase phase{ wxT("Module manager") };
+      ModuleManager::Get().Initialize(*mCmdHandler);
+   }
 
    // Parse command line and handle options that might require
    // immediate exit...no need to initialize all of the audio
@@ -1490,6 +1507,10 @@ bool AudacityApp::OnInit()
       exit(1);
    }
 
+   wxString profileName;
+   if (parser->Found(wxT("startup-profile"), &profileName))
+      StartupProfiler::Get().SetReportFile(profileName);
+
    // BG: Create a temporary window to set as the top window
    wxImage logoimage((const char **)AudacityLogoWithName_xpm);
    logoimage.Rescale(logoimage.GetWidth() / 2, logoimage.GetHeight() / 2);
@@ -1538,8 +1559,11 @@ bool AudacityApp::OnInit()
 
       // More initialization
 
-      InitDitherers();
-      InitAudioIO();
+      {
+         StartupProfiler::Phase phase{ wxT("Audio I/O") };
+         InitDitherers();
+         InitAudioIO();
+      }
 
 #ifdef __WXMAC__
 
@@ -1582,8 +1606,12 @@ bool AudacityApp::OnInit()
    // Root cause is problem with wxSplashScreen and other dialogs co-existing, that
    // seemed to arrive with wx3.
    {
+      StartupProfiler::Phase phase{ wxT("Project window") };
       project = CreateNewAudacityProject();
       mCmdHandler->SetProject(project);
+      // A macro run from the command line has nothing to show
+      if (parser->Found(wxT("macro")))
+         project->Show(false);
       wxWindow * pWnd = MakeHijackPanel();
       if (pWnd)
       {
@@ -1594,7 +1622,7 @@ bool AudacityApp::OnInit()
       }
    }
 
-   if( project->mShowSplashScreen ){
+   if( project->mShowSplashScreen && !parser->Found(wxT("macro")) ){
       // This may do a check-for-updates at every start up.
       // Mainly this is to tell users of ALPHAS who don't know that they have an ALPHA.
       // Disabled for now, after discussion.
@@ -1609,14 +1637,23 @@ bool AudacityApp::OnInit()
    // So we also call StartMonitoring when STOP is called.
    project->MayStartMonitoring();
 
-   #ifdef USE_FFMPEG
-   FFmpegStartup();
-   #endif
-
-   Importer::Get().Initialize();
+   {
+      StartupProfiler::Phase phase{ wxT("Importer") };
+      Importer::Get().Initialize();
+   }
 
    // Bug1561: delay the recovery dialog, to avoid crashes.
    CallAfter( [=] () mutable {
+      // Probing for the FFmpeg libraries is not needed to show the first
+      // window, so it waits until here, but must precede opening any files
+      // named on the command line.
+      #ifdef USE_FFMPEG
+      {
+         StartupProfiler::Phase phase{ wxT("FFmpeg (deferred)") };
+         FFmpegStartup();
+      }
+      #endif
+
       //
       // Auto-recovery
       //
@@ -1626,6 +1663,40 @@ bool AudacityApp::OnInit()
          // Important: Prevent deleting any temporary files!
          DirManager::SetDontDeleteTempFiles();
          QuitAudacity(true);
+         return;
+      }
+
+      // Apply a macro to each file named on the command line, then quit.
+      // Recovered projects are left open instead, so that nothing recovered
+      // is discarded, and the eventual exit code reports the macro as failed.
+      wxString macro;
+      if (parser->Found(wxT("macro"), &macro))
+      {
+         mExitCode = 1;
+         if (didRecoverAnything)
+         {
+            wxPrintf(_("Macro '%s' was not applied, because projects were recovered\n"),
+               macro);
+            project->Show(true);
+         }
+         else
+         {
+            MacroCommands macroCommands;
+            if (!macroCommands.ReadMacro(macro))
+               wxPrintf(_("Macro '%s' could not be read\n"), macro);
+            else
+            {
+               wxArrayString files;
+               for (size_t i = 0, cnt = parser->GetParamCount(); i < cnt; i++)
+                  files.push_back(parser->GetParam(i));
+               if (macroCommands.ApplyMacroToFiles(
+                     MacroCommandsCatalog{ project }, *project, files) == 0)
+                  mExitCode = 0;
+            }
+            StartupProfiler::Get().WriteReport();
+            QuitAudacity(true);
+            return;
+         }
       }
 
       //
@@ -1650,6 +1721,8 @@ bool AudacityApp::OnInit()
          }
 #endif
       }
+
+      StartupProfiler::Get().WriteReport();
    } );
 
    gInited = true;
@@ -2061,6 +2134,18 @@ std::unique_ptr<wxCmdLineParser> AudacityApp::ParseCommandLine()
    /*i18n-hint: This displays the Audacity version */
    parser->AddSwitch(wxT("v"), wxT("version"), _("display Audacity version"));
 
+   /*i18n-hint: This applies the named macro to each file given on the
+    *           command line, without showing the project window */
+   parser->AddLongOption(wxT("macro"),
+                         _("apply a macro to the files, then quit"),
+                         wxCMD_LINE_VAL_STRING);
+
+   /*i18n-hint: This writes the time taken by each step of starting
+    *           Audacity to the given file */
+   parser->AddLongOption(wxT("startup-profile"),
+                         _("write start-up timings to a file"),
+                         wxCMD_LINE_VAL_STRING);
+
    /*i18n-hint: This is a list of one or more files that Audacity
     *           should open upon startup */
    parser->AddParam(_("audio or project file name"),
@@ -2163,6 +2248,12 @@ void AudacityApp::AddFileToHistory(const wxString & name)
    mRecentFiles->AddFileToHistory(name);
 }
 
+int AudacityApp::OnRun()
+{
+   const auto result = wxApp::OnRun();
+   return result ? result : mExitCode;
+}
+
 int AudacityApp::OnExit()
 {
    gIsQuitting = true;
@@ -66,6 +66,7 @@ class AudacityApp final : public wxApp {
    AudacityApp();
    ~AudacityApp();
    bool OnInit(void) override;
+   int OnRun() override;
    int OnExit(void) override;
    void OnFatalException() override;
    bool OnExceptionInMainLoop() override;
@@ -205,6 +206,9 @@ class AudacityApp final : public wxApp {
 
    bool mWindowRectAlreadySaved;
 
+   // Returned from OnRun() when the main loop itself reports no error
+   int mExitCode{ 0 };
+
 #if defined(__WXMSW__)
    std::unique_ptr<IPCServ> mIPCServ;
 #else
@@ -447,6 +447,7 @@ TimeTrack and AudioIOListener and whether the playback is looped.
 #include "AudacityApp.h"
 #include "AudacityException.h"
 #include "Mix.h"
+#include "PlaybackStream.h"
 #include "Resample.h"
 #include "RingBuffer.h"
 #include "prefs/GUISettings.h"
@@ -1790,6 +1791,9 @@ int AudioIO::StartStream(const TransportTracks &tracks,
    mLastRecordingOffset = 0;
    mCaptureTracks = tracks.captureTracks;
    mPlaybackTracks = tracks.playbackTracks;
+   mPlaybackStream = options.pPlaybackStream;
+   wxASSERT(!mPlaybackStream ||
+      mPlaybackStream->GetChannels() == mPlaybackTracks.size());
 #ifdef EXPERIMENTAL_MIDI_OUT
    mMidiPlaybackTracks = tracks.midiTracks;
 #endif
@@ -1799,6 +1803,7 @@ int AudioIO::StartStream(const TransportTracks &tracks,
       if (!commit) {
          // Don't keep unnecessary shared pointers to tracks
          mPlaybackTracks.clear();
+         mPlaybackStream.reset();
          mCaptureTracks.clear();
 #ifdef EXPERIMENTAL_MIDI_OUT
          mMidiPlaybackTracks.clear();
@@ -2088,6 +2093,11 @@ bool AudioIO::AllocateBuffers(
       // more frequent polling of the mouse
       playbackTime =
          lrint(options.pScrubbingOptions->delay * mRate) / mRate;
+   else if (options.pPlaybackStream)
+      // Take little batches from a stream, so that playback can begin as
+      // soon as its producer has made a little output.  Copying from the
+      // stream is cheap, unlike mixing.
+      playbackTime = 0.1;
    
    wxASSERT( playbackTime >= 0 );
    mPlaybackSamplesToCopy = playbackTime * mRate;
@@ -2138,6 +2148,10 @@ bool AudioIO::AllocateBuffers(
             mPlaybackQueueMinimum =
                std::min( mPlaybackQueueMinimum, playbackBufferSize );
 
+            if (mPlaybackStream)
+               mPlaybackStreamBuffer.reinit(
+                  std::max( mPlaybackSamplesToCopy, mPlaybackQueueMinimum ) );
+
             for (unsigned int i = 0; i < mPlaybackTracks.size(); i++)
             {
                // Bug 1763 - We must fade in from zero to avoid a click on starting.
@@ -2247,6 +2261,8 @@ void AudioIO::StartStreamCleanup(bool bOnlyBuffers)
 
    mPlaybackBuffers.reset();
    mPlaybackMixers.reset();
+   mPlaybackStream.reset();
+   mPlaybackStreamBuffer.reset();
    mCaptureBuffers.reset();
    mResample.reset();
    mTimeQueue.mData.reset();
@@ -2290,20 +2306,40 @@ void AudioIO::PrepareMidiIterator(bool send, double offset)
       // off to another thread and want to make sure nothing happens
       // to the data until playback finishes. This is just a sanity check.
       seq->set_in_use(true);
+      // Start MIDI from current cursor position, without stepping through
+      // the events before it
       mIterator->begin_seq(seq,
          // casting away const, but allegro just uses the pointer as an opaque "cookie"
-         (void*)t, t->GetOffset() + offset);
+         (void*)t, t->GetOffset() + offset, mPlaybackSchedule.mT0 + offset);
    }
-   GetNextEvent(); // prime the pump for FillMidiBuffers
 
-   // Start MIDI from current cursor position
-   mSendMidiState = true;
-   while (mNextEvent &&
-          mNextEventTime < mPlaybackSchedule.mT0 + offset) {
-      if (send) OutputEvent();
-      GetNextEvent();
+   if (send) {
+      // Notes before the cursor are not played, but program and controller
+      // changes are sent so that the synthesizer is in the right state
+      std::vector< std::pair< Alg_event_ptr, NoteTrack* > > updates;
+      for (i = 0; i < nTracks; i++) {
+         const auto t = mMidiPlaybackTracks[i].get();
+         for (const auto event : t->UpdatesBefore(mPlaybackSchedule.mT0))
+            updates.emplace_back( event, const_cast<NoteTrack*>(t) );
+      }
+      std::stable_sort(updates.begin(), updates.end(),
+         [](const std::pair< Alg_event_ptr, NoteTrack* > &a,
+            const std::pair< Alg_event_ptr, NoteTrack* > &b) {
+            return a.first->time + a.second->GetOffset() <
+               b.first->time + b.second->GetOffset(); });
+
+      mSendMidiState = true;
+      for (const auto &update : updates) {
+         mNextEvent = update.first;
+         mNextEventTrack = update.second;
+         mNextIsNoteOn = true;
+         mNextEventTime = mNextEvent->time + mNextEventTrack->GetOffset() + offset;
+         OutputEvent();
+      }
+      mSendMidiState = false;
    }
-   mSendMidiState = false;
+
+   GetNextEvent(); // prime the pump for FillMidiBuffers
 }
 
 bool AudioIO::StartPortMidiStream()
@@ -2593,6 +2629,8 @@ void AudioIO::StopStream()
       {
          mPlaybackBuffers.reset();
          mPlaybackMixers.reset();
+         mPlaybackStream.reset();
+         mPlaybackStreamBuffer.reset();
          mTimeQueue.mData.reset();
       }
 
@@ -3775,6 +3813,13 @@ void AudioIO::FillBuffers()
       // ALL buffers, and advance the global time by that much.
       auto nAvailable = GetCommonlyFreePlayback();
 
+      // A stream may not yet have produced as much as there is room for.
+      // Don't let the schedule run ahead of its samples; the callback pads
+      // with silence until the stream catches up.
+      if (mPlaybackStream && !mPlaybackStream->IsFinished())
+         nAvailable =
+            std::min( nAvailable, mPlaybackStream->AvailForGet() );
+
       //
       // Don't fill the buffers at all unless we can do the
       // full mMaxPlaybackSecsToCopy.  This improves performance
@@ -3866,10 +3911,20 @@ void AudioIO::FillBuffers()
                if (frames > 0)
                {
                   size_t processed = 0;
-                  if ( toProcess )
-                     processed = mPlaybackMixers[i]->Process( toProcess );
-                  //wxASSERT(processed <= toProcess);
-                  warpedSamples = mPlaybackMixers[i]->GetBuffer();
+                  if (mPlaybackStream) {
+                     // The stream's samples need no resampling or warping,
+                     // and after it finishes, the rest is padding
+                     if ( toProcess )
+                        processed = mPlaybackStream->Get(
+                           i, mPlaybackStreamBuffer.get(), toProcess );
+                     warpedSamples = (samplePtr)mPlaybackStreamBuffer.get();
+                  }
+                  else {
+                     if ( toProcess )
+                        processed = mPlaybackMixers[i]->Process( toProcess );
+                     //wxASSERT(processed <= toProcess);
+                     warpedSamples = mPlaybackMixers[i]->GetBuffer();
+                  }
                   const auto put = mPlaybackBuffers[i]->Put(
                      warpedSamples, floatSample, processed, frames - processed);
                   // wxASSERT(put == frames);
@@ -5065,8 +5120,9 @@ void AudioIoCallback::UpdateTimePosition(unsigned long framesPerBuffer)
       return;
 
    // Update the position seen by drawing code
-   if (mPlaybackSchedule.Interactive())
+   if (mPlaybackSchedule.Interactive() || mPlaybackStream)
       // To do: do this in all cases and remove TrackTimeUpdate
+      // A stream may fall behind, and then time must wait for its samples
       mPlaybackSchedule.SetTrackTime( mTimeQueue.Consumer( mMaxFramesOutput, mRate ) );
    else
       mPlaybackSchedule.TrackTimeUpdate( framesPerBuffer / mRate );
@@ -54,6 +54,7 @@ using NoteTrackConstArray = std::vector < std::shared_ptr< const NoteTrack > >;
 
 class AudioIO;
 class RingBuffer;
+class PlaybackStream;
 class Mixer;
 class Resample;
 class TimeTrack;
@@ -153,6 +154,12 @@ struct AudioIOStartStreamOptions
 
    // contents may get swapped with empty vector
    PRCrossfadeData      *pCrossfadeData{};
+
+   // Non-null value indicates that playback takes its samples from this
+   // stream, as they become available, rather than from the tracks.  The
+   // tracks still determine channels, gains, mute and solo.  There must
+   // be one stream channel for each playback track.
+   std::shared_ptr<PlaybackStream> pPlaybackStream;
 };
 
 struct TransportTracks {
@@ -499,6 +506,8 @@ public:
    WaveTrackArray      mPlaybackTracks;
 
    ArrayOf<std::unique_ptr<Mixer>> mPlaybackMixers;
+   std::shared_ptr<PlaybackStream> mPlaybackStream;
+   Floats              mPlaybackStreamBuffer;
    volatile int        mStreamToken;
    static int          mNextStreamToken;
    double              mFactor;
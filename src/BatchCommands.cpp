@@ -22,9 +22,11 @@ processing.  See also MacrosWindow and ApplyMacroDialog.
 #include <wx/defs.h>
 #include <wx/dir.h>
 #include <wx/filedlg.h>
+#include <wx/stopwatch.h>
 #include <wx/textfile.h>
 
 #include "AudacityApp.h"
+#include "AudacityException.h"
 #include "Project.h"
 #include "commands/CommandManager.h"
 #include "effects/EffectManager.h"
@@ -888,6 +890,42 @@ bool MacroCommands::ApplyMacro(
    return true;
 }
 
+// ApplyMacroToFiles() does what the "Apply Macro to Files" button does,
+// but without any dialogs, so that it can be driven from the command line.
+// The time taken for each file is printed.  Returns the number of failures.
+int MacroCommands::ApplyMacroToFiles( const MacroCommandsCatalog &catalog,
+   AudacityProject &project, const wxArrayString &files )
+{
+   // Stay in batch mode between the commands too, so that importing
+   // does not prompt either.
+   project.mBatchMode++;
+   auto cleanup = finally( [&] { project.mBatchMode--; } );
+
+   int failures = 0;
+   wxStopWatch total;
+   for (const auto &file : files) {
+      wxStopWatch timer;
+      auto success = GuardedCall< bool >( [&] {
+         if (!project.Import(file))
+            return false;
+         SelectActions::DoSelectAll(project);
+         return ApplyMacro(catalog) && !mAbort;
+      } );
+      project.ResetProjectToEmpty();
+
+      wxPrintf(wxT("%s\t%ld ms\t%s\n"),
+         success ? wxT("done") : wxT("FAILED"), timer.Time(), file);
+      if (!success)
+         ++failures;
+      if (mAbort)
+         break;
+   }
+
+   wxPrintf(wxT("%d file(s), %d failed, %ld ms\n"),
+      (int)files.size(), failures, total.Time());
+   return failures;
+}
+
 // AbortBatch() allows a premature terminatation of a batch.
 void MacroCommands::AbortBatch()
 {
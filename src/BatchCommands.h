@@ -71,6 +71,8 @@ class MacroCommands final {
       const wxString & command,
       const wxString & params, const CommandContext & Context);
    bool ReportAndSkip( const wxString & friendlyCommand, const wxString & params );
+   int ApplyMacroToFiles( const MacroCommandsCatalog &catalog,
+      AudacityProject &project, const wxArrayString &files );
    void AbortBatch();
 
    // Utility functions for the special commands.
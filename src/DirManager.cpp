@@ -665,7 +665,11 @@ DirManager::ProjectSetter::Impl::Impl(
 
       int total = dirManager.mBlockFileHash.size();
 
-      bool link = moving;
+      // Block files are never written again once complete, so a hard link
+      // serves as well as a copy, also when the old project is kept; it
+      // makes "Save Project As" a matter of directory entries.  Linking
+      // stops after the first failure, for instance across volumes.
+      bool link = true;
       for (const auto &pair : dirManager.mBlockFileHash) {
          if( progress.Update(newPaths.size(), total) != ProgressResult::Success )
             return;
@@ -1311,7 +1315,10 @@ BlockFilePtr DirManager::CopyBlockFile(const BlockFilePtr &b)
       //a summary file, so we should check before we copy.
       if(b->IsSummaryAvailable())
       {
-         if( !FileNames::CopyFile(fn.GetFullPath(),
+         // The file will not change, so share it when the file system can
+         if( !FileNames::HardLinkFile(fn.GetFullPath(),
+                  newFile.GetFullPath()) &&
+             !FileNames::CopyFile(fn.GetFullPath(),
                   newFile.GetFullPath()) )
             // Disk space exhaustion, maybe
             throw FileException{
@@ -992,6 +992,20 @@ size_t Envelope::GetNumberOfPoints() const
    return mEnv.size();
 }
 
+bool Envelope::IsConstant(double &value) const
+{
+   if (mEnv.empty()) {
+      value = mDefaultValue;
+      return true;
+   }
+
+   value = mEnv[0].GetVal();
+   for (const auto &point : mEnv)
+      if (point.GetVal() != value)
+         return false;
+   return true;
+}
+
 void Envelope::GetPoints(double *bufferWhen,
                          double *bufferValue,
                          int bufferLen) const
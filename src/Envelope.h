@@ -210,6 +210,10 @@ public:
    /** \brief Return number of points */
    size_t GetNumberOfPoints() const;
 
+   /** \brief Return true, and the value, if the envelope has the same value
+    * at all times, as it does when it has fewer than two points */
+   bool IsConstant(double &value) const;
+
 private:
    int InsertOrReplaceRelative(double when, double value);
 
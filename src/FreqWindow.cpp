@@ -67,7 +67,9 @@ and in the spectrogram spectral selection.
 #include "AColor.h"
 #include "FFT.h"
 #include "Internat.h"
+#include "ParallelFor.h"
 #include "PitchName.h"
+#include "RealFFTf.h"
 #include "prefs/GUISettings.h"
 #include "Prefs.h"
 #include "Project.h"
@@ -84,6 +86,7 @@ and in the spectrogram spectral selection.
 #include "./widgets/LinkingHtmlWindow.h"
 #include "./widgets/HelpSystem.h"
 #include "widgets/ErrorDialog.h"
+#include "widgets/ProgressDialog.h"
 #include "widgets/Ruler.h"
 
 #if wxUSE_ACCESSIBILITY
@@ -497,9 +500,6 @@ FreqWindow::FreqWindow(wxWindow * parent, wxWindowID id,
 
    S.AddSpace(5);
 
-   mProgress = safenew FreqGauge(this, wxID_ANY); //, wxST_SIZEGRIP);
-   S.AddWindow(mProgress, wxEXPAND);
-
    // Log-frequency axis works for spectrum plots only.
    if (mAlg != SpectrumAnalyst::Spectrum)
    {
@@ -576,56 +576,32 @@ bool FreqWindow::Show(bool show)
 
 void FreqWindow::GetAudio()
 {
-   mData.reset();
+   mTracks.clear();
+   mDataStart = 0;
    mDataLen = 0;
 
    int selcount = 0;
-   bool warning = false;
    for (auto track : p->GetTracks()->Selected< const WaveTrack >()) {
       if (selcount==0) {
          mRate = track->GetRate();
-         auto start = track->TimeToLongSamples(p->mViewInfo.selectedRegion.t0());
+         mDataStart =
+            track->TimeToLongSamples(p->mViewInfo.selectedRegion.t0());
          auto end = track->TimeToLongSamples(p->mViewInfo.selectedRegion.t1());
-         auto dataLen = end - start;
-         if (dataLen > 10485760) {
-            warning = true;
-            mDataLen = 10485760;
-         }
-         else
-            // dataLen is not more than 10 * 2 ^ 20
-            mDataLen = dataLen.as_size_t();
-         mData = Floats{ mDataLen };
-         // Don't allow throw for bad reads
-         track->Get((samplePtr)mData.get(), floatSample, start, mDataLen,
-                    fillZero, false);
+         mDataLen = end - mDataStart;
       }
-      else {
-         if (track->GetRate() != mRate) {
-            AudacityMessageBox(_("To plot the spectrum, all selected tracks must be the same sample rate."));
-            mData.reset();
-            mDataLen = 0;
-            return;
-         }
-         auto start = track->TimeToLongSamples(p->mViewInfo.selectedRegion.t0());
-         Floats buffer2{ mDataLen };
-         // Again, stop exceptions
-         track->Get((samplePtr)buffer2.get(), floatSample, start, mDataLen,
-                    fillZero, false);
-         for (size_t i = 0; i < mDataLen; i++)
-            mData[i] += buffer2[i];
+      else if (track->GetRate() != mRate) {
+         AudacityMessageBox(_("To plot the spectrum, all selected tracks must be the same sample rate."));
+         mTracks.clear();
+         mDataLen = 0;
+         return;
       }
+      // The copy shares the sample blocks of the track, so it costs little,
+      // and later edits do not change what is plotted.  The samples are read
+      // only as the analysis needs them.
+      mTracks.push_back( std::shared_ptr<const WaveTrack>{
+         static_cast<const WaveTrack*>(track->Duplicate().release()) } );
       selcount++;
    }
-
-   if (selcount == 0)
-      return;
-
-   if (warning) {
-      wxString msg;
-      msg.Printf(_("Too much audio was selected. Only the first %.1f seconds of audio will be analyzed."),
-                          (mDataLen / mRate));
-      AudacityMessageBox(msg);
-   }
 }
 
 void FreqWindow::OnSize(wxSizeEvent & WXUNUSED(event))
@@ -661,7 +637,8 @@ void FreqWindow::DrawBackground(wxMemoryDC & dc)
 
 void FreqWindow::DrawPlot()
 {
-   if (!mData || mDataLen < mWindowSize || mAnalyst->GetProcessedSize() == 0) {
+   if (mTracks.empty() || mDataLen < mWindowSize ||
+       mAnalyst->GetProcessedSize() == 0) {
       wxMemoryDC memDC;
 
       vRuler->ruler.SetLog(false);
@@ -878,7 +855,7 @@ void FreqWindow::PlotPaint(wxPaintEvent & event)
 
    dc.DrawBitmap( *mBitmap, 0, 0, true );
    // Fix for Bug 1226 "Plot Spectrum freezes... if insufficient samples selected"
-   if (!mData || mDataLen < mWindowSize)
+   if (mTracks.empty() || mDataLen < mWindowSize)
       return;
 
    dc.SetFont(mFreqFont);
@@ -1002,7 +979,7 @@ void FreqWindow::SendRecalcEvent()
 
 void FreqWindow::Recalc()
 {
-   if (!mData || mDataLen < mWindowSize) {
+   if (mTracks.empty() || mDataLen < mWindowSize) {
       DrawPlot();
       return;
    }
@@ -1012,24 +989,44 @@ void FreqWindow::Recalc()
    int windowFunc = mFuncChoice->GetSelection();
 
    wxWindow *hadFocus = FindFocus();
-   // In wxMac, the skipped window MUST be a top level window.  I'd originally made it
-   // just the mProgress window with the idea of preventing user interaction with the
-   // controls while the plot was being recalculated.  This doesn't appear to be necessary
-   // so just use the the top level window instead.
+   bool calculated;
    {
-      Maybe<wxWindowDisabler> blocker;
-      if (IsShown())
-         blocker.create(this);
-      wxYieldIfNeeded();
-
-      mAnalyst->Calculate(alg, windowFunc, mWindowSize, mRate,
-         mData.get(), mDataLen,
-         &mYMin, &mYMax, mProgress);
+      // Sum the selected tracks as the analyst asks for the samples
+      ArrayOf<WaveTrackCache> caches{ mTracks.size() };
+      for (size_t i = 0; i < mTracks.size(); i++)
+         caches[i].SetTrack(mTracks[i]);
+      auto source = [&](sampleCount start, size_t len, float *buffer) {
+         std::fill(buffer, buffer + len, 0.0f);
+         for (size_t i = 0; i < mTracks.size(); i++) {
+            // Don't allow throw for bad reads
+            auto samples = reinterpret_cast<const float *>(
+               caches[i].Get(floatSample, mDataStart + start, len, false));
+            if (samples)
+               for (size_t j = 0; j < len; j++)
+                  buffer[j] += samples[j];
+         }
+      };
+
+      // The dialog disables the other windows, and appears only if the
+      // analysis takes a while
+      ProgressDialog progress{ GetTitle(), _("Analyzing the selection") };
+      calculated = mAnalyst->Calculate(alg, windowFunc, mWindowSize, mRate,
+         source, mDataLen, &mYMin, &mYMax,
+         [&](sampleCount done, sampleCount total) {
+            return progress.Update(done.as_double(), total.as_double())
+               == ProgressResult::Success;
+         });
    }
    if (hadFocus) {
       hadFocus->SetFocus();
    }
 
+   if (!calculated) {
+      // Invalid or cancelled; the plot is left empty
+      DrawPlot();
+      return;
+   }
+
    if (alg == SpectrumAnalyst::Spectrum) {
       if(mYMin < -dBRange)
          mYMin = -dBRange;
@@ -1194,11 +1191,157 @@ void FreqGauge::Reset()
    Refresh(true);
 }
 
+namespace {
+
+// The sums, over a run of consecutive windows, of the values that
+// SpectrumAnalyst plots
+struct WindowSums
+{
+   size_t first; // index of the first window, counting from the batch
+   size_t count;
+   std::vector<double> sums;
+};
+
+// data points to the first sample of the first window
+void SumWindows(SpectrumAnalyst::Algorithm alg, size_t windowSize,
+                const float *win, const float *data, WindowSums &result)
+{
+   auto half = windowSize / 2;
+   result.sums.assign(half, 0.0);
+
+   if (alg == SpectrumAnalyst::Spectrum) {
+      // Window all of the frames, then transform them together
+      auto hFFT = GetFFT(windowSize);
+      Floats buffer{ result.count * windowSize };
+      for (size_t w = 0; w < result.count; w++) {
+         auto frame = &buffer[w * windowSize];
+         auto samples = data + w * half;
+         for (size_t i = 0; i < windowSize; i++)
+            frame[i] = win[i] * samples[i];
+      }
+      RealFFTfBatch(buffer.get(), result.count, windowSize, hFFT.get());
+
+      // Power, as PowerSpectrum finds it
+      for (size_t w = 0; w < result.count; w++) {
+         auto pFFT = &buffer[w * windowSize];
+         result.sums[0] += pFFT[0] * pFFT[0];
+         for (size_t i = 1; i < half; i++) {
+            const auto index = hFFT->BitReversed[i];
+            result.sums[i] += (pFFT[index] * pFFT[index])
+               + (pFFT[index + 1] * pFFT[index + 1]);
+         }
+      }
+      return;
+   }
+
+   Floats in{ windowSize };
+   Floats out{ windowSize };
+   Floats out2{ windowSize };
+
+   for (size_t w = 0; w < result.count; w++) {
+      auto samples = data + w * half;
+      for (size_t i = 0; i < windowSize; i++)
+         in[i] = win[i] * samples[i];
+
+      switch (alg) {
+         case SpectrumAnalyst::Autocorrelation:
+         case SpectrumAnalyst::CubeRootAutocorrelation:
+         case SpectrumAnalyst::EnhancedAutocorrelation:
+
+            // Take FFT
+            RealFFT(windowSize, in.get(), out.get(), out2.get());
+            // Compute power
+            for (size_t i = 0; i < windowSize; i++)
+               in[i] = (out[i] * out[i]) + (out2[i] * out2[i]);
+
+            if (alg == SpectrumAnalyst::Autocorrelation) {
+               for (size_t i = 0; i < windowSize; i++)
+                  in[i] = sqrt(in[i]);
+            }
+            if (alg == SpectrumAnalyst::CubeRootAutocorrelation ||
+                alg == SpectrumAnalyst::EnhancedAutocorrelation) {
+               // Tolonen and Karjalainen recommend taking the cube root
+               // of the power, instead of the square root
+
+               for (size_t i = 0; i < windowSize; i++)
+                  in[i] = pow(in[i], 1.0f / 3.0f);
+            }
+            // Take FFT
+            RealFFT(windowSize, in.get(), out.get(), out2.get());
+
+            // Take real part of result
+            for (size_t i = 0; i < half; i++)
+               result.sums[i] += out[i];
+            break;
+
+         case SpectrumAnalyst::Cepstrum:
+            RealFFT(windowSize, in.get(), out.get(), out2.get());
+
+            // Compute log power
+            // Set a sane lower limit assuming maximum time amplitude of 1.0
+            {
+               float power;
+               float minpower = 1e-20*windowSize*windowSize;
+               for (size_t i = 0; i < windowSize; i++)
+               {
+                  power = (out[i] * out[i]) + (out2[i] * out2[i]);
+                  if(power < minpower)
+                     in[i] = log(minpower);
+                  else
+                     in[i] = log(power);
+               }
+               // Take IFFT
+               InverseRealFFT(windowSize, in.get(), NULL, out.get());
+
+               // Take real part of result
+               for (size_t i = 0; i < half; i++)
+                  result.sums[i] += out[i];
+            }
+
+            break;
+
+         default:
+            wxASSERT(false);
+            break;
+      }                         //switch
+   }
+}
+
+}
+
 bool SpectrumAnalyst::Calculate(Algorithm alg, int windowFunc,
                                 size_t windowSize, double rate,
                                 const float *data, size_t dataLen,
                                 float *pYMin, float *pYMax,
                                 FreqGauge *progress)
+{
+   if (progress)
+      progress->SetRange(dataLen);
+   auto cleanup = finally( [&] {
+      if (progress)
+         // Reset for next time
+         progress->Reset();
+   } );
+
+   return Calculate(alg, windowFunc, windowSize, rate,
+      [data](sampleCount start, size_t len, float *buffer) {
+         auto first = data + start.as_size_t();
+         std::copy(first, first + len, buffer);
+      },
+      dataLen, pYMin, pYMax,
+      [progress](sampleCount done, sampleCount) {
+         if (progress)
+            progress->SetValue(done.as_size_t());
+         return true;
+      });
+}
+
+bool SpectrumAnalyst::Calculate(Algorithm alg, int windowFunc,
+                                size_t windowSize, double rate,
+                                const SampleSource &source,
+                                sampleCount dataLen,
+                                float *pYMin, float *pYMax,
+                                const ProgressCallback &progress)
 {
    // Wipe old data
    mProcessed.resize(0);
@@ -1227,9 +1370,7 @@ bool SpectrumAnalyst::Calculate(Algorithm alg, int windowFunc,
    auto half = mWindowSize / 2;
    mProcessed.resize(mWindowSize);
 
-   Floats in{ mWindowSize };
    Floats out{ mWindowSize };
-   Floats out2{ mWindowSize };
    Floats win{ mWindowSize };
 
    for (size_t i = 0; i < mWindowSize; i++) {
@@ -1249,98 +1390,51 @@ bool SpectrumAnalyst::Calculate(Algorithm alg, int windowFunc,
    else
       wss = 1.0;
 
-   if (progress) {
-      progress->SetRange(dataLen);
-   }
-
-   size_t start = 0;
-   int windows = 0;
-   while (start + mWindowSize <= dataLen) {
-      for (size_t i = 0; i < mWindowSize; i++)
-         in[i] = win[i] * data[start + i];
-
-      switch (alg) {
-         case Spectrum:
-            PowerSpectrum(mWindowSize, in.get(), out.get());
-
-            for (size_t i = 0; i < half; i++)
-               mProcessed[i] += out[i];
-            break;
-
-         case Autocorrelation:
-         case CubeRootAutocorrelation:
-         case EnhancedAutocorrelation:
-
-            // Take FFT
-            RealFFT(mWindowSize, in.get(), out.get(), out2.get());
-            // Compute power
-            for (size_t i = 0; i < mWindowSize; i++)
-               in[i] = (out[i] * out[i]) + (out2[i] * out2[i]);
-
-            if (alg == Autocorrelation) {
-               for (size_t i = 0; i < mWindowSize; i++)
-                  in[i] = sqrt(in[i]);
-            }
-            if (alg == CubeRootAutocorrelation ||
-                alg == EnhancedAutocorrelation) {
-               // Tolonen and Karjalainen recommend taking the cube root
-               // of the power, instead of the square root
-
-               for (size_t i = 0; i < mWindowSize; i++)
-                  in[i] = pow(in[i], 1.0f / 3.0f);
-            }
-            // Take FFT
-            RealFFT(mWindowSize, in.get(), out.get(), out2.get());
-
-            // Take real part of result
-            for (size_t i = 0; i < half; i++)
-               mProcessed[i] += out[i];
-            break;
-
-         case Cepstrum:
-            RealFFT(mWindowSize, in.get(), out.get(), out2.get());
-
-            // Compute log power
-            // Set a sane lower limit assuming maximum time amplitude of 1.0
-            {
-               float power;
-               float minpower = 1e-20*mWindowSize*mWindowSize;
-               for (size_t i = 0; i < mWindowSize; i++)
-               {
-                  power = (out[i] * out[i]) + (out2[i] * out2[i]);
-                  if(power < minpower)
-                     in[i] = log(minpower);
-                  else
-                     in[i] = log(power);
-               }
-               // Take IFFT
-               InverseRealFFT(mWindowSize, in.get(), NULL, out.get());
-
-               // Take real part of result
-               for (size_t i = 0; i < half; i++)
-                  mProcessed[i] += out[i];
-            }
-
-            break;
+   const size_t windows =
+      (dataLen - mWindowSize).as_long_long() / half + 1;
+
+   // Each thread sums a run of this many windows.  The runs do not depend
+   // on the number of threads, and their sums are added in order, so
+   // neither does the result.
+   const size_t runLength = std::max<size_t>(1, 65536 / mWindowSize);
+   const size_t nThreads = ParallelForConcurrency();
+
+   std::vector<double> total(half, 0.0);
+   std::vector<float> batch;
+   size_t window = 0;
+   while (window < windows) {
+      std::vector<WindowSums> runs;
+      for (auto next = window;
+           runs.size() < nThreads && next < windows; next += runLength)
+         runs.push_back({ next - window, std::min(runLength, windows - next) });
+
+      // Read the samples of the whole batch of windows on this thread
+      const auto batchWindows = runs.back().first + runs.back().count;
+      batch.resize((batchWindows - 1) * half + mWindowSize);
+      source(sampleCount(window) * half, batch.size(), batch.data());
+
+      ParallelFor(runs.size(), [&](size_t ii) {
+         auto &run = runs[ii];
+         SumWindows(alg, mWindowSize, win.get(),
+            &batch[run.first * half], run);
+      } );
+
+      for (const auto &run : runs) {
+         for (size_t i = 0; i < half; i++)
+            total[i] += run.sums[i];
+      }
 
-         default:
-            wxASSERT(false);
-            break;
-      }                         //switch
+      window += batchWindows;
 
-      // Update the progress bar
-      if (progress) {
-         progress->SetValue(start);
+      // Update the progress, and stop if asked
+      if (!progress(sampleCount(window) * half, dataLen)) {
+         mProcessed.resize(0);
+         return false;
       }
-
-      start += half;
-      windows++;
    }
 
-   if (progress) {
-      // Reset for next time
-      progress->Reset();
-   }
+   for (size_t i = 0; i < half; i++)
+      mProcessed[i] = total[i];
 
    float mYMin = 1000000, mYMax = -1000000;
    double scale;
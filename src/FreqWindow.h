@@ -12,6 +12,7 @@
 #define __AUDACITY_FREQ_WINDOW__
 
 #include "MemoryX.h"
+#include <functional>
 #include <vector>
 #include <wx/brush.h>
 #include <wx/dcmemory.h>
@@ -40,6 +41,7 @@ class AudacityProject;
 class FreqWindow;
 class FreqGauge;
 class RulerPanel;
+class WaveTrack;
 
 DECLARE_EXPORTED_EVENT_TYPE(AUDACITY_DLL_API, EVT_FREQWINDOW_RECALC, -1);
 
@@ -57,6 +59,13 @@ public:
       NumAlgorithms
    };
 
+   // Fills buffer with len samples of the data, counting start from zero
+   using SampleSource =
+      std::function< void(sampleCount start, size_t len, float *buffer) >;
+   // Reports how much of the data has been analyzed; return false to stop
+   using ProgressCallback =
+      std::function< bool(sampleCount done, sampleCount total) >;
+
    SpectrumAnalyst();
    ~SpectrumAnalyst();
 
@@ -68,6 +77,16 @@ public:
       float *pYMin = NULL, float *pYMax = NULL, // outputs
       FreqGauge *progress = NULL);
 
+   // Reads the data from source a batch of windows at a time, analyzing
+   // the windows of each batch on several threads.
+   // Return true iff successful and not stopped by progress
+   bool Calculate(Algorithm alg,
+      int windowFunc, // see FFT.h for values
+      size_t windowSize, double rate,
+      const SampleSource &source, sampleCount dataLen,
+      float *pYMin, float *pYMax, // outputs
+      const ProgressCallback &progress);
+
    const float *GetProcessed() const;
    int GetProcessedSize() const;
 
@@ -177,7 +196,6 @@ private:
    RulerPanel *vRuler;
    RulerPanel *hRuler;
    FreqPlot *mFreqPlot;
-   FreqGauge *mProgress;
 
    wxRect mPlotRect;
 
@@ -201,8 +219,10 @@ private:
 
 
    double mRate;
-   size_t mDataLen;
-   Floats mData;
+   // Copies of the selected tracks, summed as they are read
+   std::vector< std::shared_ptr<const WaveTrack> > mTracks;
+   sampleCount mDataStart;
+   sampleCount mDataLen;
    size_t mWindowSize;
 
    bool mLogAxis;
@@ -238,7 +238,6 @@ Mixer::Mixer(const WaveTrackConstArray &inputTracks,
    // and placed in a queue, when mixing with resampling.
    // (Should we use WaveTrack::GetBestBlockSize instead?)
    , mQueueMaxLen{ 65536 }
-   , mSampleQueue{ mNumInputTracks, mQueueMaxLen }
 
    , mNumChannels{ numOutChannels }
    , mGains{ mNumChannels }
@@ -255,6 +254,27 @@ Mixer::Mixer(const WaveTrackConstArray &inputTracks,
       mInputTrack[i].SetTrack(inputTracks[i]);
       mSamplePos[i] = inputTracks[i]->TimeToLongSamples(startTime);
    }
+
+   // When resampling, the channels of a stereo track are mixed as one
+   // group.  mGroupSize is the number of channels for the first track of
+   // each group, and zero for the others.
+   size_t maxGroupSize = 1;
+   mGroupSize.resize(mNumInputTracks);
+   for(size_t i=0; i<mNumInputTracks; i++) {
+      const auto &track = inputTracks[i];
+      if (i + 1 < mNumInputTracks &&
+          track->GetLinked() &&
+          track->GetLink() == inputTracks[i + 1].get() &&
+          track->GetRate() == inputTracks[i + 1]->GetRate()) {
+         mGroupSize[i] = 2;
+         mGroupSize[i + 1] = 0;
+         maxGroupSize = 2;
+         ++i;
+      }
+      else
+         mGroupSize[i] = 1;
+   }
+
    mTimeTrack = warpOptions.timeTrack;
    mT0 = startTime;
    mT1 = stopTime;
@@ -287,6 +307,10 @@ Mixer::Mixer(const WaveTrackConstArray &inputTracks,
       mTemp[c].Allocate(mInterleavedBufferSize, floatSample);
    }
    mFloatBuffer = Floats{ mInterleavedBufferSize };
+   if (maxGroupSize > 1) {
+      mResampleBuffer.reinit(mBufferSize * maxGroupSize);
+      mChannelBuffer.reinit(mQueueMaxLen);
+   }
 
    // But cut the queue into blocks of this finer size
    // for variable rate resampling.  Each block is resampled at some
@@ -298,6 +322,10 @@ Mixer::Mixer(const WaveTrackConstArray &inputTracks,
 
    // For each queue, the number of available samples after the queue start.
    mQueueLen.reinit(mNumInputTracks);
+   mSampleQueue.reinit(mNumInputTracks);
+   for (size_t i = 0; i<mNumInputTracks; i++)
+      if (mGroupSize[i] > 0)
+         mSampleQueue[i].reinit(mQueueMaxLen * mGroupSize[i]);
    mResample.reinit(mNumInputTracks);
    mMinFactor.resize(mNumInputTracks);
    mMaxFactor.resize(mNumInputTracks);
@@ -338,7 +366,9 @@ Mixer::~Mixer()
 void Mixer::MakeResamplers()
 {
    for (size_t i = 0; i < mNumInputTracks; i++)
-      mResample[i] = std::make_unique<Resample>(mHighQuality, mMinFactor[i], mMaxFactor[i]);
+      if (mGroupSize[i] > 0)
+         mResample[i] = std::make_unique<Resample>(
+            mHighQuality, mMinFactor[i], mMaxFactor[i], mGroupSize[i]);
 }
 
 void Mixer::ApplyTrackGains(bool apply)
@@ -382,16 +412,26 @@ void MixBuffers(unsigned numChannels, int *channelFlags, float *gains,
    }
 }
 
-size_t Mixer::MixVariableRates(int *channelFlags, WaveTrackCache &cache,
-                                    sampleCount *pos, float *queue,
-                                    int *queueStart, int *queueLen,
-                                    Resample * pResample)
+size_t Mixer::MixVariableRates(size_t iTrack, size_t nChannels)
 {
-   const WaveTrack *const track = cache.GetTrack().get();
+   // The channels of a group share one position and one queue, in which
+   // their samples are interleaved, so that one resampler serves them all
+   // and the warp factor is computed once for the group.
+   const WaveTrack *const track = mInputTrack[iTrack].GetTrack().get();
+   sampleCount *const pos = &mSamplePos[iTrack];
+   float *const queue = mSampleQueue[iTrack].get();
+   int *const queueStart = &mQueueStart[iTrack];
+   int *const queueLen = &mQueueLen[iTrack];
+   Resample *const pResample = mResample[iTrack].get();
+
    const double trackRate = track->GetRate();
    const double initialWarp = mRate / mSpeed / trackRate;
    const double tstep = 1.0 / trackRate;
-   auto sampleSize = SAMPLE_SIZE(floatSample);
+   auto sampleSize = SAMPLE_SIZE(floatSample) * nChannels;
+
+   // Resampled output, interleaved if there is more than one channel
+   float *const resampled =
+      nChannels > 1 ? mResampleBuffer.get() : mFloatBuffer.get();
 
    decltype(mMaxOut) out = 0;
 
@@ -406,9 +446,14 @@ size_t Mixer::MixVariableRates(int *channelFlags, WaveTrackCache &cache,
     *       to calculate the position.
     */
 
-   // Find the last sample
+   // Find the last sample of any channel
    double endTime = track->GetEndTime();
    double startTime = track->GetStartTime();
+   for (size_t c = 1; c < nChannels; c++) {
+      const auto channel = mInputTrack[iTrack + c].GetTrack().get();
+      endTime = std::max(endTime, channel->GetEndTime());
+      startTime = std::min(startTime, channel->GetStartTime());
+   }
    const bool backwards = (mT1 < mT0);
    const double tEnd = backwards
       ? std::max(startTime, mT1)
@@ -421,7 +466,7 @@ size_t Mixer::MixVariableRates(int *channelFlags, WaveTrackCache &cache,
    while (out < mMaxOut) {
       if (*queueLen < (int)mProcessLen) {
          // Shift pending portion to start of the buffer
-         memmove(queue, &queue[*queueStart], (*queueLen) * sampleSize);
+         memmove(queue, &queue[*queueStart * nChannels], (*queueLen) * sampleSize);
          *queueStart = 0;
 
          auto getLen = limitSampleBufferSize(
@@ -431,39 +476,35 @@ size_t Mixer::MixVariableRates(int *channelFlags, WaveTrackCache &cache,
 
          // Nothing to do if past end of play interval
          if (getLen > 0) {
-            if (backwards) {
-               auto results = cache.Get(floatSample, *pos - (getLen - 1), getLen, mMayThrow);
-               if (results)
-                  memcpy(&queue[*queueLen], results, sizeof(float) * getLen);
-               else
-                  memset(&queue[*queueLen], 0, sizeof(float) * getLen);
+            const auto start = backwards ? *pos - (getLen - 1) : *pos;
+            for (size_t c = 0; c < nChannels; c++) {
+               auto &cache = mInputTrack[iTrack + c];
+               float *const buffer = nChannels > 1
+                  ? mChannelBuffer.get() : &queue[*queueLen];
 
-               track->GetEnvelopeValues(mEnvValues.get(),
-                                        getLen,
-                                        (*pos - (getLen- 1)).as_double() / trackRate);
-               *pos -= getLen;
-            }
-            else {
-               auto results = cache.Get(floatSample, *pos, getLen, mMayThrow);
+               auto results = cache.Get(floatSample, start, getLen, mMayThrow);
                if (results)
-                  memcpy(&queue[*queueLen], results, sizeof(float) * getLen);
+                  memcpy(buffer, results, sizeof(float) * getLen);
                else
-                  memset(&queue[*queueLen], 0, sizeof(float) * getLen);
+                  memset(buffer, 0, sizeof(float) * getLen);
 
-               track->GetEnvelopeValues(mEnvValues.get(),
-                                        getLen,
-                                        (*pos).as_double() / trackRate);
+               ApplyEnvelope(*cache.GetTrack(), buffer, getLen,
+                             start.as_double() / trackRate);
 
-               *pos += getLen;
-            }
+               if (backwards)
+                  ReverseSamples((samplePtr)buffer, floatSample, 0, getLen);
 
-            for (decltype(getLen) i = 0; i < getLen; i++) {
-               queue[(*queueLen) + i] *= mEnvValues[i];
+               if (nChannels > 1) {
+                  float *dest = &queue[*queueLen * nChannels + c];
+                  for (decltype(getLen) i = 0; i < getLen; i++, dest += nChannels)
+                     *dest = buffer[i];
+               }
             }
 
             if (backwards)
-               ReverseSamples((samplePtr)&queue[0], floatSample,
-                              *queueLen, getLen);
+               *pos -= getLen;
+            else
+               *pos += getLen;
 
             *queueLen += getLen;
          }
@@ -492,10 +533,10 @@ size_t Mixer::MixVariableRates(int *channelFlags, WaveTrackCache &cache,
       }
 
       auto results = pResample->Process(factor,
-                                      &queue[*queueStart],
+                                      &queue[*queueStart * nChannels],
                                       thisProcessLen,
                                       last,
-                                      &mFloatBuffer[out],
+                                      &resampled[out * nChannels],
                                       mMaxOut - out);
 
       const auto input_used = results.first;
@@ -509,26 +550,64 @@ size_t Mixer::MixVariableRates(int *channelFlags, WaveTrackCache &cache,
       }
    }
 
-   for (size_t c = 0; c < mNumChannels; c++) {
-      if (mApplyTrackGains) {
-         mGains[c] = track->GetChannelGain(c);
+   // Followers keep the position of the leader
+   for (size_t c = 1; c < nChannels; c++)
+      mSamplePos[iTrack + c] = *pos;
+
+   ArrayOf<int> channelFlags{ mNumChannels };
+   for (size_t c = 0; c < nChannels; c++) {
+      const auto channel = mInputTrack[iTrack + c].GetTrack().get();
+
+      if (nChannels > 1) {
+         const float *src = &resampled[c];
+         for (decltype(out) i = 0; i < out; i++, src += nChannels)
+            mFloatBuffer[i] = *src;
       }
-      else {
-         mGains[c] = 1.0;
+
+      for (size_t j = 0; j < mNumChannels; j++) {
+         if (mApplyTrackGains) {
+            mGains[j] = channel->GetChannelGain(j);
+         }
+         else {
+            mGains[j] = 1.0;
+         }
       }
-   }
 
-   MixBuffers(mNumChannels,
-              channelFlags,
-              mGains.get(),
-              (samplePtr)mFloatBuffer.get(),
-              mTemp.get(),
-              out,
-              mInterleaved);
+      GetChannelFlags(iTrack + c, channelFlags.get());
+      MixBuffers(mNumChannels,
+                 channelFlags.get(),
+                 mGains.get(),
+                 (samplePtr)mFloatBuffer.get(),
+                 mTemp.get(),
+                 out,
+                 mInterleaved);
+   }
 
    return out;
 }
 
+void Mixer::ApplyEnvelope(const WaveTrack &track,
+                          float *buffer, size_t len, double t0)
+{
+   const double t1 = t0 + len / track.GetRate();
+
+   // Envelopes are usually flat, and most often at unity gain, so avoid
+   // evaluating them sample by sample
+   double value;
+   if (track.GetEnvelopeConstant(t0, t1, value)) {
+      if (value != 1.0) {
+         const auto gain = static_cast<float>(value);
+         for (size_t i = 0; i < len; i++)
+            buffer[i] *= gain;
+      }
+      return;
+   }
+
+   track.GetEnvelopeValues(mEnvValues.get(), len, t0);
+   for (size_t i = 0; i < len; i++)
+      buffer[i] *= mEnvValues[i]; // Track gain control will go here?
+}
+
 size_t Mixer::MixSameRate(int *channelFlags, WaveTrackCache &cache,
                                sampleCount *pos)
 {
@@ -559,9 +638,7 @@ size_t Mixer::MixSameRate(int *channelFlags, WaveTrackCache &cache,
          memcpy(mFloatBuffer.get(), results, sizeof(float) * slen);
       else
          memset(mFloatBuffer.get(), 0, sizeof(float) * slen);
-      track->GetEnvelopeValues(mEnvValues.get(), slen, t - (slen - 1) / mRate);
-      for(decltype(slen) i = 0; i < slen; i++)
-         mFloatBuffer[i] *= mEnvValues[i]; // Track gain control will go here?
+      ApplyEnvelope(*track, mFloatBuffer.get(), slen, t - (slen - 1) / mRate);
       ReverseSamples((samplePtr)mFloatBuffer.get(), floatSample, 0, slen);
 
       *pos -= slen;
@@ -572,9 +649,7 @@ size_t Mixer::MixSameRate(int *channelFlags, WaveTrackCache &cache,
          memcpy(mFloatBuffer.get(), results, sizeof(float) * slen);
       else
          memset(mFloatBuffer.get(), 0, sizeof(float) * slen);
-      track->GetEnvelopeValues(mEnvValues.get(), slen, t);
-      for(decltype(slen) i = 0; i < slen; i++)
-         mFloatBuffer[i] *= mEnvValues[i]; // Track gain control will go here?
+      ApplyEnvelope(*track, mFloatBuffer.get(), slen, t);
 
       *pos += slen;
    }
@@ -591,6 +666,37 @@ size_t Mixer::MixSameRate(int *channelFlags, WaveTrackCache &cache,
    return slen;
 }
 
+void Mixer::GetChannelFlags(size_t iTrack, int *channelFlags) const
+{
+   const WaveTrack *const track = mInputTrack[iTrack].GetTrack().get();
+   for(size_t j=0; j<mNumChannels; j++)
+      channelFlags[j] = 0;
+
+   if( mMixerSpec ) {
+      //ignore left and right when downmixing is not required
+      for(size_t j = 0; j < mNumChannels; j++ )
+         channelFlags[ j ] = mMixerSpec->mMap[ iTrack ][ j ] ? 1 : 0;
+   }
+   else {
+      switch(track->GetChannel()) {
+      case Track::MonoChannel:
+      default:
+         for(size_t j=0; j<mNumChannels; j++)
+            channelFlags[j] = 1;
+         break;
+      case Track::LeftChannel:
+         channelFlags[0] = 1;
+         break;
+      case Track::RightChannel:
+         if (mNumChannels >= 2)
+            channelFlags[1] = 1;
+         else
+            channelFlags[0] = 1;
+         break;
+      }
+   }
+}
+
 size_t Mixer::Process(size_t maxToProcess)
 {
    // MB: this is wrong! mT represented warped time, and mTime is too inaccurate to use
@@ -606,40 +712,17 @@ size_t Mixer::Process(size_t maxToProcess)
    Clear();
    for(size_t i=0; i<mNumInputTracks; i++) {
       const WaveTrack *const track = mInputTrack[i].GetTrack().get();
-      for(size_t j=0; j<mNumChannels; j++)
-         channelFlags[j] = 0;
-
-      if( mMixerSpec ) {
-         //ignore left and right when downmixing is not required
-         for(size_t j = 0; j < mNumChannels; j++ )
-            channelFlags[ j ] = mMixerSpec->mMap[ i ][ j ] ? 1 : 0;
+      if (mbVariableRates || track->GetRate() != mRate) {
+         // Followers are mixed together with their leader
+         if (mGroupSize[i] > 0)
+            maxOut = std::max(maxOut,
+               MixVariableRates(i, mGroupSize[i]));
       }
       else {
-         switch(track->GetChannel()) {
-         case Track::MonoChannel:
-         default:
-            for(size_t j=0; j<mNumChannels; j++)
-               channelFlags[j] = 1;
-            break;
-         case Track::LeftChannel:
-            channelFlags[0] = 1;
-            break;
-         case Track::RightChannel:
-            if (mNumChannels >= 2)
-               channelFlags[1] = 1;
-            else
-               channelFlags[0] = 1;
-            break;
-         }
-      }
-      if (mbVariableRates || track->GetRate() != mRate)
-         maxOut = std::max(maxOut,
-            MixVariableRates(channelFlags.get(), mInputTrack[i],
-               &mSamplePos[i], mSampleQueue[i].get(),
-               &mQueueStart[i], &mQueueLen[i], mResample[i].get()));
-      else
+         GetChannelFlags(i, channelFlags.get());
          maxOut = std::max(maxOut,
             MixSameRate(channelFlags.get(), mInputTrack[i], &mSamplePos[i]));
+      }
 
       double t = mSamplePos[i].as_double() / (double)track->GetRate();
       if (mT0 > mT1)
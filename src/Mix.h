@@ -152,13 +152,18 @@ class AUDACITY_DLL_API Mixer {
    size_t MixSameRate(int *channelFlags, WaveTrackCache &cache,
                            sampleCount *pos);
 
-   size_t MixVariableRates(int *channelFlags, WaveTrackCache &cache,
-                                sampleCount *pos, float *queue,
-                                int *queueStart, int *queueLen,
-                                Resample * pResample);
+   // Mix the group of nChannels input tracks starting at iTrack
+   size_t MixVariableRates(size_t iTrack, size_t nChannels);
+
+   void GetChannelFlags(size_t iTrack, int *channelFlags) const;
 
    void MakeResamplers();
 
+   // Multiply samples fetched for times from t0 onwards by the track's
+   // envelope
+   void ApplyEnvelope(const WaveTrack &track,
+                      float *buffer, size_t len, double t0);
+
  private:
 
     // Input
@@ -172,6 +177,7 @@ class AUDACITY_DLL_API Mixer {
    double           mT0; // Start time
    double           mT1; // Stop time (none if mT0==mT1)
    double           mTime;  // Current time (renamed from mT to mTime for consistency with AudioIO - mT represented warped time there)
+   std::vector<size_t> mGroupSize;
    ArrayOf<std::unique_ptr<Resample>> mResample;
    size_t           mQueueMaxLen;
    FloatBuffers     mSampleQueue;
@@ -191,6 +197,8 @@ class AUDACITY_DLL_API Mixer {
    bool             mInterleaved;
    ArrayOf<SampleBuffer> mBuffer, mTemp;
    Floats           mFloatBuffer;
+   Floats           mResampleBuffer; // interleaved output of a group
+   Floats           mChannelBuffer;  // one channel of a group before interleaving
    double           mRate;
    double           mSpeed;
    bool             mHighQuality;
@@ -25,6 +25,8 @@
 
 #if defined(USE_MIDI)
 #include <sstream>
+#include <algorithm>
+#include <limits>
 
 #define ROUND(x) ((int) ((x) + 0.5))
 
@@ -107,6 +109,19 @@ NoteTrack::Holder TrackFactory::NewNoteTrack()
    return std::make_unique<NoteTrack>(mDirManager);
 }
 
+struct NoteTrack::EventIndex
+{
+   // What the sequence was like when the index was made.  Edits that do
+   // not go through NoteTrack are noticed when one of these differs.
+   const Alg_seq *seq;
+   long nEvents;
+   double dur;
+
+   EventPointers notes;            // in order of start time
+   std::vector<double> latestEnd;  // latest end of notes[0] .. notes[i]
+   EventPointers updates;          // in order of time
+};
+
 NoteTrack::NoteTrack(const std::shared_ptr<DirManager> &projDirManager)
    : NoteTrackBase(projDirManager)
 {
@@ -153,6 +168,83 @@ Alg_seq &NoteTrack::GetSeq() const
    return *mSeq;
 }
 
+auto NoteTrack::GetEventIndex() const -> const EventIndex &
+{
+   auto &seq = GetSeq();
+   // Times are compared with seconds; does nothing if already converted
+   seq.convert_to_seconds();
+
+   long nEvents = 0;
+   const auto nTracks = seq.tracks();
+   for (int i = 0; i < nTracks; ++i)
+      nEvents += seq.track(i)->length();
+
+   if (mEventIndex &&
+       mEventIndex->seq == &seq &&
+       mEventIndex->nEvents == nEvents &&
+       mEventIndex->dur == seq.get_real_dur())
+      return *mEventIndex;
+
+   auto index = std::make_unique<EventIndex>();
+   index->seq = &seq;
+   index->nEvents = nEvents;
+   index->dur = seq.get_real_dur();
+
+   for (int i = 0; i < nTracks; ++i) {
+      auto &events = *seq.track(i);
+      for (long j = 0, nn = events.length(); j < nn; ++j) {
+         const auto event = events[j];
+         if (event->is_note())
+            index->notes.push_back(event);
+         else
+            index->updates.push_back(event);
+      }
+   }
+
+   const auto earlier = [](Alg_event_ptr a, Alg_event_ptr b)
+      { return a->time < b->time; };
+   std::stable_sort(index->notes.begin(), index->notes.end(), earlier);
+   std::stable_sort(index->updates.begin(), index->updates.end(), earlier);
+
+   double latest = -std::numeric_limits<double>::infinity();
+   index->latestEnd.reserve(index->notes.size());
+   for (const auto note : index->notes) {
+      latest = std::max(latest, note->get_end_time());
+      index->latestEnd.push_back(latest);
+   }
+
+   mEventIndex = std::move(index);
+   return *mEventIndex;
+}
+
+auto NoteTrack::NotesNear(double t0, double t1) const -> EventRange
+{
+   const auto &index = GetEventIndex();
+   const auto &notes = index.notes;
+   const auto &latestEnd = index.latestEnd;
+   t0 -= GetOffset();
+   t1 -= GetOffset();
+
+   // Skip the notes that, with all before them, end by t0; then stop at
+   // the first note starting at t1 or later
+   const auto nSkip =
+      std::upper_bound(latestEnd.begin(), latestEnd.end(), t0)
+         - latestEnd.begin();
+   const auto first = notes.begin() + nSkip;
+   const auto last = std::lower_bound(first, notes.end(), t1,
+      [](Alg_event_ptr note, double time){ return note->time < time; });
+   return { first, last };
+}
+
+auto NoteTrack::UpdatesBefore(double t) const -> EventRange
+{
+   const auto &updates = GetEventIndex().updates;
+   t -= GetOffset();
+   return { updates.begin(),
+      std::lower_bound(updates.begin(), updates.end(), t,
+         [](Alg_event_ptr event, double time){ return event->time < time; }) };
+}
+
 Track::Holder NoteTrack::Duplicate() const
 {
    auto duplicate = std::make_unique<NoteTrack>(mDirManager);
@@ -230,6 +322,9 @@ void NoteTrack::WarpAndTransposeNotes(double t0, double t1,
                                       const TimeWarper &warper,
                                       double semitones)
 {
+   // Times change in place
+   InvalidateEventIndex();
+
    double offset = this->GetOffset(); // track is shifted this amount
    auto &seq = GetSeq();
    seq.convert_to_seconds(); // make sure time units are right
@@ -391,6 +486,7 @@ bool NoteTrack::LabelClick(const wxRect &rect, int mx, int my, bool right)
 
 void NoteTrack::SetSequence(std::unique_ptr<Alg_seq> &&seq)
 {
+   InvalidateEventIndex();
    mSeq = std::move(seq);
 }
 
@@ -471,6 +567,7 @@ Track::Holder NoteTrack::Cut(double t0, double t1)
    seq.convert_to_seconds();
    newTrack->mSeq.reset(seq.cut(t0 - GetOffset(), len, false));
    newTrack->SetOffset(0);
+   InvalidateEventIndex();
 
    // Not needed
    // Alg_seq::cut seems to handle this
@@ -522,6 +619,7 @@ bool NoteTrack::Trim(double t0, double t1)
    seq.clear(t1 - GetOffset(), seq.get_dur() + 10000.0, false);
    // Now that stuff beyond selection is cleared, clear before selection:
    seq.clear(0.0, t0 - GetOffset(), false);
+   InvalidateEventIndex();
    // want starting time to be t0
    SetOffset(t0);
 
@@ -540,6 +638,7 @@ void NoteTrack::Clear(double t0, double t1)
    double len = t1-t0;
 
    auto &seq = GetSeq();
+   InvalidateEventIndex();
 
    auto offset = GetOffset();
    auto start = t0 - offset;
@@ -604,6 +703,7 @@ void NoteTrack::Paste(double t, const Track *src)
       //delta += other->GetSeq().get_real_dur();
 
       seq.paste(t - GetOffset(), &other->GetSeq());
+      InvalidateEventIndex();
 
       AddToDuration( delta );
 
@@ -628,6 +728,7 @@ void NoteTrack::Silence(double t0, double t1)
    // If it's set, then it seems like notes are silenced if they start or end in the range,
    // otherwise only if they start in the range. --Poke
    seq.silence(t0 - GetOffset(), len, false);
+   InvalidateEventIndex();
 }
 
 void NoteTrack::InsertSilence(double t, double len)
@@ -638,6 +739,7 @@ void NoteTrack::InsertSilence(double t, double len)
    auto &seq = GetSeq();
    seq.convert_to_seconds();
    seq.insert_silence(t - GetOffset(), len);
+   InvalidateEventIndex();
 
    // is this needed?
    // AddToDuration( len );
@@ -655,6 +757,7 @@ void NoteTrack::SetVelocity(float velocity)
 // NOT the function that handles horizontal dragging.
 bool NoteTrack::Shift(double t) // t is always seconds
 {
+   InvalidateEventIndex();
    if (t > 0) {
       auto &seq = GetSeq();
       // insert an even number of measures
@@ -706,6 +809,7 @@ void NoteTrack::AddToDuration( double delta )
 bool NoteTrack::StretchRegion
    ( QuantizedTimeAndBeat t0, QuantizedTimeAndBeat t1, double newDur )
 {
+   InvalidateEventIndex();
    auto &seq = GetSeq();
    bool result = seq.stretch_region( t0.second, t1.second, newDur );
    if (result) {
@@ -86,6 +86,20 @@ class AUDACITY_DLL_API NoteTrack final
 
    Alg_seq &GetSeq() const;
 
+   using EventPointers = std::vector<Alg_event_ptr>;
+   using EventRange = IteratorRange<EventPointers::const_iterator>;
+
+   // Notes that may sound at some time from t0 to t1, in order of start
+   // time.  Times include the track offset.  The range may hold a few notes
+   // outside the span, so callers still test each one.  It comes from an
+   // index that is rebuilt when the sequence changes, which also converts
+   // the sequence to seconds.
+   EventRange NotesNear(double t0, double t1) const;
+
+   // Events other than notes, such as program and controller changes,
+   // that come before time t (including the track offset), in time order
+   EventRange UpdatesBefore(double t) const;
+
    void WarpAndTransposeNotes(double t0, double t1,
                               const TimeWarper &warper, double semitones);
 
@@ -249,6 +263,13 @@ class AUDACITY_DLL_API NoteTrack final
    mutable std::unique_ptr<char[]> mSerializationBuffer;
    mutable long mSerializationLength;
 
+   // Events of the sequence sorted by time, for drawing and for starting
+   // playback part way through
+   struct EventIndex;
+   const EventIndex &GetEventIndex() const;
+   void InvalidateEventIndex() { mEventIndex.reset(); }
+   mutable std::unique_ptr<EventIndex> mEventIndex;
+
 #ifdef EXPERIMENTAL_MIDI_OUT
    float mVelocity; // velocity offset
 #endif
@@ -0,0 +1,165 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  ParallelFor.cpp
+
+*******************************************************************//**
+
+\file ParallelFor.cpp
+\brief A pool of worker threads, started on first use, one fewer than the
+CPUs, so that effects and analyses can split their work without creating
+and joining threads for each block.
+
+*//*******************************************************************/
+
+#include "Audacity.h"
+#include "ParallelFor.h"
+
+#include "MemoryX.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <wx/thread.h>
+
+namespace {
+
+class ThreadPool
+{
+public:
+   ThreadPool()
+      : mConcurrency{ (size_t)std::max(1, wxThread::GetCPUCount()) }
+   {
+      for (size_t ii = 1; ii < mConcurrency; ++ii)
+         mThreads.emplace_back( [this] { Work(); } );
+   }
+
+   ~ThreadPool()
+   {
+      {
+         std::lock_guard<std::mutex> lock{ mMutex };
+         mStopping = true;
+      }
+      mWake.notify_all();
+      for (auto &thread : mThreads)
+         thread.join();
+   }
+
+   size_t Concurrency() const { return mConcurrency; }
+
+   // Returns false, having called nothing, if another job has the pool
+   bool Run(size_t count, const std::function< void(size_t) > &fn)
+   {
+      bool idle = false;
+      if (!mBusy.compare_exchange_strong(idle, true))
+         return false;
+      auto cleanup = finally( [this] { mBusy = false; } );
+
+      {
+         std::lock_guard<std::mutex> lock{ mMutex };
+         mFn = &fn;
+         mCount = count;
+         mNext = 0;
+         mException = nullptr;
+         mPending = mThreads.size();
+         ++mJob;
+      }
+      mWake.notify_all();
+
+      Take();
+
+      std::exception_ptr exception;
+      {
+         // The workers use fn until each has found no more to take
+         std::unique_lock<std::mutex> lock{ mMutex };
+         mDone.wait(lock, [this] { return mPending == 0; });
+         mFn = nullptr;
+         exception = mException;
+         mException = nullptr;
+      }
+      if (exception)
+         std::rethrow_exception(exception);
+      return true;
+   }
+
+private:
+   // Called on the caller's thread and on each worker
+   void Take()
+   {
+      for (size_t ii; (ii = mNext++) < mCount;) {
+         try {
+            (*mFn)(ii);
+         }
+         catch (...) {
+            std::lock_guard<std::mutex> lock{ mMutex };
+            if (!mException)
+               mException = std::current_exception();
+         }
+      }
+   }
+
+   void Work()
+   {
+      unsigned long job = 0;
+      while (true) {
+         {
+            std::unique_lock<std::mutex> lock{ mMutex };
+            mWake.wait(lock, [&] { return mStopping || mJob != job; });
+            if (mStopping)
+               return;
+            job = mJob;
+         }
+
+         Take();
+
+         std::lock_guard<std::mutex> lock{ mMutex };
+         if (--mPending == 0)
+            mDone.notify_one();
+      }
+   }
+
+   const size_t mConcurrency;
+   std::vector<std::thread> mThreads;
+
+   std::atomic<bool> mBusy{ false };
+
+   std::mutex mMutex;
+   std::condition_variable mWake, mDone;
+   bool mStopping{ false };
+   unsigned long mJob{ 0 };
+   size_t mPending{ 0 };
+   std::exception_ptr mException;
+
+   // Not changed while any thread is in Take()
+   const std::function< void(size_t) > *mFn{};
+   size_t mCount{ 0 };
+
+   std::atomic<size_t> mNext{ 0 };
+};
+
+ThreadPool &Pool()
+{
+   static ThreadPool pool;
+   return pool;
+}
+
+}
+
+void ParallelFor(size_t count, const std::function< void(size_t) > &fn)
+{
+   if (count > 1 && Pool().Concurrency() > 1 && Pool().Run(count, fn))
+      return;
+
+   for (size_t ii = 0; ii < count; ++ii)
+      fn(ii);
+}
+
+size_t ParallelForConcurrency()
+{
+   return Pool().Concurrency();
+}
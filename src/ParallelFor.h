@@ -0,0 +1,32 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  ParallelFor.h
+
+  Spreads independent pieces of work over a pool of threads.
+
+**********************************************************************/
+
+#ifndef __AUDACITY_PARALLEL_FOR__
+#define __AUDACITY_PARALLEL_FOR__
+
+#include "Audacity.h"
+
+#include <cstddef>
+#include <functional>
+
+// Calls fn(0), fn(1), ... fn(count - 1), in no particular order, on the
+// calling thread and on a pool of worker threads that lives as long as the
+// program.  Returns when every call has returned.  If any call throws, the
+// others still run, and then one of the exceptions is rethrown here.
+//
+// The calls run one at a time on the calling thread when there is only one
+// CPU, or when the pool is busy, as when ParallelFor() is called from one of
+// the calls.
+AUDACITY_DLL_API void ParallelFor(size_t count, const std::function< void(size_t) > &fn);
+
+// How many calls of ParallelFor() may run at once, counting the caller's
+AUDACITY_DLL_API size_t ParallelForConcurrency();
+
+#endif
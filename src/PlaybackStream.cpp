@@ -0,0 +1,77 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  PlaybackStream.cpp
+
+*******************************************************************//*!
+
+\class PlaybackStream
+\brief Holds samples for playback that are produced while playback is
+already under way, such as the output of an effect being previewed.
+
+  One thread writes and one thread reads, as for RingBuffer, with one
+  RingBuffer for each channel.  The writer puts equal numbers of samples
+  in all channels, so the reader can take the least available among them.
+
+  Once the writer calls Finish(), no more samples will come, and the reader
+  may then pad with silence whatever it still needs.
+
+*//*******************************************************************/
+
+#include "PlaybackStream.h"
+
+#include <algorithm>
+#include "RingBuffer.h"
+
+PlaybackStream::PlaybackStream(unsigned nChannels, size_t size)
+   : mNumChannels{ nChannels }
+   , mBuffers{ nChannels }
+{
+   for (unsigned ii = 0; ii < mNumChannels; ++ii)
+      mBuffers[ii] = std::make_unique<RingBuffer>(floatSample, size);
+}
+
+PlaybackStream::~PlaybackStream()
+{
+}
+
+size_t PlaybackStream::AvailForPut()
+{
+   auto result = mBuffers[0]->AvailForPut();
+   for (unsigned ii = 1; ii < mNumChannels; ++ii)
+      result = std::min(result, mBuffers[ii]->AvailForPut());
+   return result;
+}
+
+size_t PlaybackStream::Put(const float *const *buffers, size_t samples)
+{
+   samples = std::min(samples, AvailForPut());
+   for (unsigned ii = 0; ii < mNumChannels; ++ii)
+      mBuffers[ii]->Put((samplePtr)buffers[ii], floatSample, samples);
+   return samples;
+}
+
+void PlaybackStream::Finish()
+{
+   // Samples put before this are visible to a reader that sees it
+   mFinished.store(true, std::memory_order_release);
+}
+
+size_t PlaybackStream::AvailForGet()
+{
+   auto result = mBuffers[0]->AvailForGet();
+   for (unsigned ii = 1; ii < mNumChannels; ++ii)
+      result = std::min(result, mBuffers[ii]->AvailForGet());
+   return result;
+}
+
+bool PlaybackStream::IsFinished() const
+{
+   return mFinished.load(std::memory_order_acquire);
+}
+
+size_t PlaybackStream::Get(unsigned channel, float *buffer, size_t samples)
+{
+   return mBuffers[channel]->Get((samplePtr)buffer, floatSample, samples);
+}
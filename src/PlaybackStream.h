@@ -0,0 +1,50 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  PlaybackStream.h
+
+*******************************************************************/
+
+#ifndef __AUDACITY_PLAYBACK_STREAM__
+#define __AUDACITY_PLAYBACK_STREAM__
+
+#include "MemoryX.h"
+#include <atomic>
+#include <memory>
+
+class RingBuffer;
+
+class PlaybackStream {
+ public:
+   PlaybackStream(unsigned nChannels, size_t size);
+   ~PlaybackStream();
+
+   unsigned GetChannels() const { return mNumChannels; }
+
+   //
+   // For the writer only:
+   //
+
+   size_t AvailForPut();
+   // Puts the same number of samples to each channel, from buffers[channel]
+   size_t Put(const float *const *buffers, size_t samples);
+   // No more samples will be put
+   void Finish();
+
+   //
+   // For the reader only:
+   //
+
+   // The number of samples available in every channel
+   size_t AvailForGet();
+   bool IsFinished() const;
+   size_t Get(unsigned channel, float *buffer, size_t samples);
+
+ private:
+   const unsigned mNumChannels;
+   ArrayOf<std::unique_ptr<RingBuffer>> mBuffers;
+   std::atomic<bool> mFinished{ false };
+};
+
+#endif /*  __AUDACITY_PLAYBACK_STREAM__ */
@@ -1739,14 +1739,21 @@ PluginManager & PluginManager::Get()
 void PluginManager::Initialize()
 {
    // Always load the registry first
-   Load();
+   const bool registryCurrent = Load();
 
    // Then look for providers (they may autoregister plugins)
    ModuleManager::Get().DiscoverProviders();
 
    // And finally check for updates
 #ifndef EXPERIMENTAL_EFFECT_MANAGEMENT
-   CheckForUpdates();
+   // Asking every provider (Vamp, LV2, ...) to search its paths for NEW
+   // plugins is slow.  Users who turn off the check at start up get only
+   // a revalidation of the known plugins, and the plugin manager dialog
+   // still does the full check.  A missing or older registry always gets
+   // the full check, so that plugins are found on first run.
+   bool bFull = true;
+   gPrefs->Read(wxT("/Plugins/CheckForUpdates"), &bFull, true);
+   CheckForUpdates( registryCurrent && !bFull );
 #else
    const bool kFast = true;
    CheckForUpdates( kFast );
@@ -1887,7 +1894,7 @@ bool PluginManager::DropFile(const wxString &fileName)
    return false;
 }
 
-void PluginManager::Load()
+bool PluginManager::Load()
 {
    // Create/Open the registry
    wxFileConfig registry(wxEmptyString, wxEmptyString, FileNames::PluginRegistry());
@@ -1898,13 +1905,14 @@ void PluginManager::Load()
    {
       // Must start over
       registry.DeleteAll();
-      return;
+      return false;
    }
 
    // Check for a registry version that we can understand
    // TODO: Should also check for a registry file that is newer than
    // what we can understand.
    wxString regver = registry.Read(REGVERKEY);
+   const bool current = !(regver < REGVERCUR);
    if (regver < REGVERCUR )
    {
       // Conversion code here, for when registry version changes.
@@ -1966,7 +1974,7 @@ void PluginManager::Load()
    LoadGroup(&registry, PluginTypeImporter);
 
    LoadGroup(&registry, PluginTypeStub);
-   return;
+   return current;
 }
 
 void PluginManager::LoadGroup(wxFileConfig *pRegistry, PluginType type)
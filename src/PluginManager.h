@@ -268,7 +268,8 @@ private:
    PluginManager();
    ~PluginManager();
 
-   void Load();
+   // Returns false if the registry was missing or of an older version
+   bool Load();
    void LoadGroup(wxFileConfig *pRegistry, PluginType type);
    void Save();
    void SaveGroup(wxFileConfig *pRegistry, PluginType type);
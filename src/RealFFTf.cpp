@@ -50,6 +50,32 @@
 #include "RealFFTf48x.h"
 #endif
 
+// The butterflies of the wider stages can use SSE, and AVX where the
+// processor has it.  Both compute exactly what the scalar loops compute,
+// operation for operation, so results do not depend on the processor.
+#if defined(__SSE__) || defined(_M_X64) || \
+   (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define FFT_SSE_BUTTERFLIES
+#include <xmmintrin.h>
+#endif
+
+#if defined(FFT_SSE_BUTTERFLIES) && \
+   (defined(__x86_64__) || defined(__i386__) || \
+    defined(_M_X64) || defined(_M_IX86))
+#if defined(__GNUC__)
+#define FFT_AVX_BUTTERFLIES
+#define FFT_TARGET_AVX __attribute__((target("avx")))
+#elif defined(_MSC_VER) && _MSC_VER >= 1600
+#define FFT_AVX_BUTTERFLIES
+#define FFT_TARGET_AVX
+#include <intrin.h>
+#endif
+#endif
+
+#ifdef FFT_AVX_BUTTERFLIES
+#include <immintrin.h>
+#endif
+
 #ifndef M_PI
 #define	M_PI		3.14159265358979323846  /* pi */
 #endif
@@ -146,6 +172,274 @@ void FFTDeleter::operator() (FFTParam *hFFT) const
       delete hFFT;
 }
 
+/*
+*  Butterfly stages.  Each performs all the butterflies of one pass of the
+*  FFT, ButterfliesPerGroup to a group, for groups spanning the buffer.
+*  The vector versions do several adjacent butterflies of a group at once,
+*  so they apply only when a group has at least that many.
+*/
+namespace {
+
+using ButterflyStage = void (*)(fft_type *buffer, const fft_type *sinTable,
+   size_t points, size_t butterfliesPerGroup);
+
+void ForwardStage(fft_type *buffer, const fft_type *sinTable,
+   size_t points, size_t butterfliesPerGroup)
+{
+   fft_type *A = buffer;
+   fft_type *B = buffer + butterfliesPerGroup * 2;
+   const fft_type *sptr = sinTable;
+   const fft_type *const endptr1 = buffer + points * 2;
+
+   while(A < endptr1)
+   {
+      const fft_type sin = *sptr;
+      const fft_type cos = *(sptr+1);
+      const fft_type *const endptr2 = B;
+      while(A < endptr2)
+      {
+         const fft_type v1 = *B * cos + *(B + 1) * sin;
+         const fft_type v2 = *B * sin - *(B + 1) * cos;
+         *B = (*A + v1);
+         *(A++) = *(B++) - 2 * v1;
+         *B = (*A - v2);
+         *(A++) = *(B++) + 2 * v2;
+      }
+      A = B;
+      B += butterfliesPerGroup * 2;
+      sptr += 2;
+   }
+}
+
+void InverseStage(fft_type *buffer, const fft_type *sinTable,
+   size_t points, size_t butterfliesPerGroup)
+{
+   fft_type *A = buffer;
+   fft_type *B = buffer + butterfliesPerGroup * 2;
+   const fft_type *sptr = sinTable;
+   const fft_type *const endptr1 = buffer + points * 2;
+
+   while(A < endptr1)
+   {
+      const fft_type sin = *(sptr++);
+      const fft_type cos = *(sptr++);
+      const fft_type *const endptr2 = B;
+      while(A < endptr2)
+      {
+         const fft_type v1 = *B * cos - *(B + 1) * sin;
+         const fft_type v2 = *B * sin + *(B + 1) * cos;
+         *B = (*A + v1) * (fft_type)0.5;
+         *(A++) = *(B++) - v1;
+         *B = (*A + v2) * (fft_type)0.5;
+         *(A++) = *(B++) - v2;
+      }
+      A = B;
+      B += butterfliesPerGroup * 2;
+   }
+}
+
+// In the vector versions, V holds (v1, v2) for each butterfly, found as
+// re(B) * (cos, sin) + im(B) * (sin, -cos) going forward, or
+// re(B) * (cos, sin) + im(B) * (-sin, cos) going back.  Negating a factor
+// or a term, and adding a value to itself to double it, are exact, so each
+// element rounds just as in the scalar stage.
+
+#ifdef FFT_SSE_BUTTERFLIES
+
+// Two butterflies at a time
+void ForwardStageSSE(fft_type *buffer, const fft_type *sinTable,
+   size_t points, size_t butterfliesPerGroup)
+{
+   const __m128 negateImag = _mm_set_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+   fft_type *A = buffer;
+   const fft_type *sptr = sinTable;
+   const fft_type *const endptr1 = buffer + points * 2;
+   const auto span = butterfliesPerGroup * 2;
+
+   for (; A < endptr1; A += span, sptr += 2)
+   {
+      const fft_type sin = *sptr;
+      const fft_type cos = *(sptr+1);
+      const __m128 cosSin = _mm_set_ps(sin, cos, sin, cos);
+      const __m128 sinNegCos = _mm_set_ps(-cos, sin, -cos, sin);
+      fft_type *B = A + span;
+      for (const fft_type *const endptr2 = B; A < endptr2; A += 4, B += 4)
+      {
+         const __m128 b = _mm_loadu_ps(B);
+         const __m128 re = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 2, 0, 0));
+         const __m128 im = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 1, 1));
+         const __m128 v = _mm_add_ps(
+            _mm_mul_ps(re, cosSin), _mm_mul_ps(im, sinNegCos));
+         // (v1, -v2)
+         const __m128 w = _mm_xor_ps(v, negateImag);
+         const __m128 newB = _mm_add_ps(_mm_loadu_ps(A), w);
+         _mm_storeu_ps(B, newB);
+         _mm_storeu_ps(A, _mm_sub_ps(newB, _mm_add_ps(w, w)));
+      }
+   }
+}
+
+void InverseStageSSE(fft_type *buffer, const fft_type *sinTable,
+   size_t points, size_t butterfliesPerGroup)
+{
+   const __m128 half = _mm_set1_ps(0.5f);
+   fft_type *A = buffer;
+   const fft_type *sptr = sinTable;
+   const fft_type *const endptr1 = buffer + points * 2;
+   const auto span = butterfliesPerGroup * 2;
+
+   for (; A < endptr1; A += span, sptr += 2)
+   {
+      const fft_type sin = *sptr;
+      const fft_type cos = *(sptr+1);
+      const __m128 cosSin = _mm_set_ps(sin, cos, sin, cos);
+      const __m128 negSinCos = _mm_set_ps(cos, -sin, cos, -sin);
+      fft_type *B = A + span;
+      for (const fft_type *const endptr2 = B; A < endptr2; A += 4, B += 4)
+      {
+         const __m128 b = _mm_loadu_ps(B);
+         const __m128 re = _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 2, 0, 0));
+         const __m128 im = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 3, 1, 1));
+         const __m128 v = _mm_add_ps(
+            _mm_mul_ps(re, cosSin), _mm_mul_ps(im, negSinCos));
+         const __m128 newB = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(A), v), half);
+         _mm_storeu_ps(B, newB);
+         _mm_storeu_ps(A, _mm_sub_ps(newB, v));
+      }
+   }
+}
+
+#endif
+
+#ifdef FFT_AVX_BUTTERFLIES
+
+// Four butterflies at a time
+FFT_TARGET_AVX
+void ForwardStageAVX(fft_type *buffer, const fft_type *sinTable,
+   size_t points, size_t butterfliesPerGroup)
+{
+   const __m256 negateImag =
+      _mm256_set_ps(-0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f);
+   fft_type *A = buffer;
+   const fft_type *sptr = sinTable;
+   const fft_type *const endptr1 = buffer + points * 2;
+   const auto span = butterfliesPerGroup * 2;
+
+   for (; A < endptr1; A += span, sptr += 2)
+   {
+      const fft_type sin = *sptr;
+      const fft_type cos = *(sptr+1);
+      const __m256 cosSin =
+         _mm256_set_ps(sin, cos, sin, cos, sin, cos, sin, cos);
+      const __m256 sinNegCos =
+         _mm256_set_ps(-cos, sin, -cos, sin, -cos, sin, -cos, sin);
+      fft_type *B = A + span;
+      for (const fft_type *const endptr2 = B; A < endptr2; A += 8, B += 8)
+      {
+         const __m256 b = _mm256_loadu_ps(B);
+         const __m256 re = _mm256_moveldup_ps(b);
+         const __m256 im = _mm256_movehdup_ps(b);
+         const __m256 v = _mm256_add_ps(
+            _mm256_mul_ps(re, cosSin), _mm256_mul_ps(im, sinNegCos));
+         // (v1, -v2)
+         const __m256 w = _mm256_xor_ps(v, negateImag);
+         const __m256 newB = _mm256_add_ps(_mm256_loadu_ps(A), w);
+         _mm256_storeu_ps(B, newB);
+         _mm256_storeu_ps(A, _mm256_sub_ps(newB, _mm256_add_ps(w, w)));
+      }
+   }
+}
+
+FFT_TARGET_AVX
+void InverseStageAVX(fft_type *buffer, const fft_type *sinTable,
+   size_t points, size_t butterfliesPerGroup)
+{
+   const __m256 half = _mm256_set1_ps(0.5f);
+   fft_type *A = buffer;
+   const fft_type *sptr = sinTable;
+   const fft_type *const endptr1 = buffer + points * 2;
+   const auto span = butterfliesPerGroup * 2;
+
+   for (; A < endptr1; A += span, sptr += 2)
+   {
+      const fft_type sin = *sptr;
+      const fft_type cos = *(sptr+1);
+      const __m256 cosSin =
+         _mm256_set_ps(sin, cos, sin, cos, sin, cos, sin, cos);
+      const __m256 negSinCos =
+         _mm256_set_ps(cos, -sin, cos, -sin, cos, -sin, cos, -sin);
+      fft_type *B = A + span;
+      for (const fft_type *const endptr2 = B; A < endptr2; A += 8, B += 8)
+      {
+         const __m256 b = _mm256_loadu_ps(B);
+         const __m256 re = _mm256_moveldup_ps(b);
+         const __m256 im = _mm256_movehdup_ps(b);
+         const __m256 v = _mm256_add_ps(
+            _mm256_mul_ps(re, cosSin), _mm256_mul_ps(im, negSinCos));
+         const __m256 newB =
+            _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(A), v), half);
+         _mm256_storeu_ps(B, newB);
+         _mm256_storeu_ps(A, _mm256_sub_ps(newB, v));
+      }
+   }
+}
+
+bool HaveAVX()
+{
+#if defined(__GNUC__)
+   return __builtin_cpu_supports("avx");
+#else
+   // The processor must support AVX, and the operating system must save
+   // the YMM registers
+   int info[4];
+   __cpuid(info, 1);
+   const bool osxsave = (info[2] & (1 << 27)) != 0;
+   const bool avx = (info[2] & (1 << 28)) != 0;
+   return osxsave && avx && (_xgetbv(0) & 6) == 6;
+#endif
+}
+
+#endif
+
+struct ButterflyKernels
+{
+   struct Stages {
+      ButterflyStage forward, inverse;
+   };
+
+   // Indexed by the number of butterflies done at once, as a power of two
+   Stages stages[3] {
+      { ForwardStage, InverseStage },
+      { ForwardStage, InverseStage },
+      { ForwardStage, InverseStage },
+   };
+
+   ButterflyKernels()
+   {
+#ifdef FFT_SSE_BUTTERFLIES
+      stages[1] = stages[2] = { ForwardStageSSE, InverseStageSSE };
+#endif
+#ifdef FFT_AVX_BUTTERFLIES
+      if (HaveAVX())
+         stages[2] = { ForwardStageAVX, InverseStageAVX };
+#endif
+   }
+
+   const Stages &Choose(size_t butterfliesPerGroup) const
+   {
+      return stages[ butterfliesPerGroup >= 4 ? 2
+         : butterfliesPerGroup >= 2 ? 1 : 0 ];
+   }
+};
+
+const ButterflyKernels &GetButterflyKernels()
+{
+   static const ButterflyKernels kernels;
+   return kernels;
+}
+
+}
+
 /*
 *  Forward FFT routine.  Must call GetFFT(fftlen) first!
 *
@@ -167,8 +461,6 @@ void FFTDeleter::operator() (FFTParam *hFFT) const
 void RealFFTf(fft_type *buffer, const FFTParam *h)
 {
    fft_type *A,*B;
-   const fft_type *sptr;
-   const fft_type *endptr1,*endptr2;
    const int *br1,*br2;
    fft_type HRplus,HRminus,HIplus,HIminus;
    fft_type v1,v2,sin,cos;
@@ -183,32 +475,11 @@ void RealFFTf(fft_type *buffer, const FFTParam *h)
    *     Bin-----Bout
    */
 
-   endptr1 = buffer + h->Points * 2;
-
+   const auto &kernels = GetButterflyKernels();
    while(ButterfliesPerGroup > 0)
    {
-      A = buffer;
-      B = buffer + ButterfliesPerGroup * 2;
-      sptr = h->SinTable.get();
-
-      while(A < endptr1)
-      {
-         sin = *sptr;
-         cos = *(sptr+1);
-         endptr2 = B;
-         while(A < endptr2)
-         {
-            v1 = *B * cos + *(B + 1) * sin;
-            v2 = *B * sin - *(B + 1) * cos;
-            *B = (*A + v1);
-            *(A++) = *(B++) - 2 * v1;
-            *B = (*A - v2);
-            *(A++) = *(B++) + 2 * v2;
-         }
-         A = B;
-         B += ButterfliesPerGroup * 2;
-         sptr += 2;
-      }
+      kernels.Choose(ButterfliesPerGroup).forward(
+         buffer, h->SinTable.get(), h->Points, ButterfliesPerGroup);
       ButterfliesPerGroup >>= 1;
    }
    /* Massage output to get the output for a real input sequence. */
@@ -246,6 +517,12 @@ void RealFFTf(fft_type *buffer, const FFTParam *h)
    buffer[1]=v1;
 }
 
+void RealFFTfBatch(fft_type *buffer, size_t count, size_t stride,
+                   const FFTParam *h)
+{
+   for (size_t ii = 0; ii < count; ++ii, buffer += stride)
+      RealFFTf(buffer, h);
+}
 
 /* Description: This routine performs an inverse FFT to real data.
 *              This code is for floating point data.
@@ -269,8 +546,6 @@ void RealFFTf(fft_type *buffer, const FFTParam *h)
 void InverseRealFFTf(fft_type *buffer, const FFTParam *h)
 {
    fft_type *A,*B;
-   const fft_type *sptr;
-   const fft_type *endptr1,*endptr2;
    const int *br1;
    fft_type HRplus,HRminus,HIplus,HIminus;
    fft_type v1,v2,sin,cos;
@@ -320,31 +595,11 @@ void InverseRealFFTf(fft_type *buffer, const FFTParam *h)
    *     Bin-----Bout
    */
 
-   endptr1 = buffer + h->Points * 2;
-
+   const auto &kernels = GetButterflyKernels();
    while(ButterfliesPerGroup > 0)
    {
-      A = buffer;
-      B = buffer + ButterfliesPerGroup * 2;
-      sptr = h->SinTable.get();
-
-      while(A < endptr1)
-      {
-         sin = *(sptr++);
-         cos = *(sptr++);
-         endptr2 = B;
-         while(A < endptr2)
-         {
-            v1 = *B * cos - *(B + 1) * sin;
-            v2 = *B * sin + *(B + 1) * cos;
-            *B = (*A + v1) * (fft_type)0.5;
-            *(A++) = *(B++) - v1;
-            *B = (*A + v2) * (fft_type)0.5;
-            *(A++) = *(B++) - v2;
-         }
-         A = B;
-         B += ButterfliesPerGroup * 2;
-      }
+      kernels.Choose(ButterfliesPerGroup).inverse(
+         buffer, h->SinTable.get(), h->Points, ButterfliesPerGroup);
       ButterfliesPerGroup >>= 1;
    }
 }
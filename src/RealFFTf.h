@@ -25,6 +25,9 @@ using HFFT = std::unique_ptr<
 
 HFFT GetFFT(size_t);
 void RealFFTf(fft_type *, const FFTParam *);
+// Transforms count frames in place, each of 2 * Points values, beginning
+// stride values apart
+void RealFFTfBatch(fft_type *, size_t count, size_t stride, const FFTParam *);
 void InverseRealFFTf(fft_type *, const FFTParam *);
 void ReorderToTime(const FFTParam *hFFT, const fft_type *buffer, fft_type *TimeOut);
 void ReorderToFreq(const FFTParam *hFFT, const fft_type *buffer,
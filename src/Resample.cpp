@@ -30,7 +30,8 @@
 
 #include <soxr.h>
 
-Resample::Resample(const bool useBestMethod, const double dMinFactor, const double dMaxFactor)
+Resample::Resample(const bool useBestMethod, const double dMinFactor, const double dMaxFactor,
+                   unsigned numChannels)
 {
    this->SetMethod(useBestMethod);
    soxr_quality_spec_t q_spec;
@@ -44,7 +45,7 @@ Resample::Resample(const bool useBestMethod, const double dMinFactor, const doub
       mbWantConstRateResampling = false; // variable rate resampling
       q_spec = soxr_quality_spec(SOXR_HQ, SOXR_VR);
    }
-   mHandle.reset(soxr_create(1, dMinFactor, 1, 0, 0, &q_spec, 0));
+   mHandle.reset(soxr_create(1, dMinFactor, numChannels, 0, 0, &q_spec, 0));
 }
 
 Resample::~Resample()
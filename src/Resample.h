@@ -42,7 +42,10 @@ class Resample final
    /// the fast method.
    // dMinFactor and dMaxFactor specify the range of factors for variable-rate resampling.
    // For constant-rate, pass the same value for both.
-   Resample(const bool useBestMethod, const double dMinFactor, const double dMaxFactor);
+   // With more than one channel, Process() takes and gives interleaved
+   // samples, and lengths count frames of all channels.
+   Resample(const bool useBestMethod, const double dMinFactor, const double dMaxFactor,
+            unsigned numChannels = 1);
    ~Resample();
 
    static EncodedEnumSetting FastMethodSetting;
@@ -59,7 +62,8 @@ class Resample final
     * This function may do nothing if you don't pass a large enough output
     * buffer (i.e. there is no where to put a full block of output data)
     @param factor The scaling factor to resample by.
-    @param inBuffer Buffer of input samples to be processed (mono)
+    @param inBuffer Buffer of input samples to be processed (interleaved
+    if there is more than one channel)
     @param inBufferLen Length of the input buffer, in samples.
     @param lastFlag Flag to indicate this is the last lot of input samples and
     the buffer needs to be emptied out into the rate converter.
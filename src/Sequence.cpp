@@ -387,6 +387,94 @@ float Sequence::GetRMS(sampleCount start, sampleCount len, bool mayThrow) const
    return sqrt(sumsq / length.as_double() );
 }
 
+bool Sequence::ScanWithSummaries(sampleCount start, sampleCount len,
+   const SummaryPredicate &ruledIn, const SummaryVisitor &visit,
+   bool mayThrow) const
+{
+   if (len <= 0 || mBlock.size() == 0)
+      return true;
+
+   // Neighbouring pieces of the same kind join into one run, so that
+   // samples are read in pieces as large as a block.
+   Floats buffer;
+   sampleCount runStart = start, runLen = 0;
+   bool runRuledIn = false;
+   auto flush = [&]() -> bool {
+      if (runLen == 0)
+         return true;
+      if (runRuledIn)
+         return visit(runStart, runLen, nullptr);
+      if (!buffer)
+         buffer.reinit(mMaxSamples);
+      for (sampleCount done = 0; done < runLen;) {
+         const auto count = limitSampleBufferSize(mMaxSamples, runLen - done);
+         Get((samplePtr)buffer.get(), floatSample, runStart + done, count,
+             mayThrow);
+         if (!visit(runStart + done, count, buffer.get()))
+            return false;
+         done += count;
+      }
+      return true;
+   };
+   auto add = [&](sampleCount pieceStart, sampleCount pieceLen,
+                  bool pieceRuledIn) -> bool {
+      if (runLen > 0 && pieceRuledIn == runRuledIn) {
+         runLen += pieceLen;
+         return true;
+      }
+      if (!flush())
+         return false;
+      runStart = pieceStart;
+      runLen = pieceLen;
+      runRuledIn = pieceRuledIn;
+      return true;
+   };
+
+   const auto end = start + len;
+   const unsigned block0 = FindBlock(start);
+   const unsigned block1 = FindBlock(end - 1);
+   Floats summary{ 3 * (mMaxSamples / 256 + 1) };
+
+   for (auto b = block0; b <= block1; ++b) {
+      const SeqBlock &theBlock = mBlock[b];
+      const auto &theFile = theBlock.f;
+      const auto s0 = std::max(start, theBlock.start);
+      const auto s1 = std::min(end, theBlock.start + theFile->GetLength());
+
+      // First try the min and max of the entire block, which are in memory
+      bool read256 = false;
+      if (theFile->IsSummaryAvailable()) {
+         auto results = theFile->GetMinMaxRMS(mayThrow);
+         if (ruledIn(results.min, results.max)) {
+            if (!add(s0, s1 - s0, true))
+               return false;
+            continue;
+         }
+         read256 = true;
+      }
+
+      // Then the 256-sample summaries of the part of the block in range
+      const auto first = (s0 - theBlock.start).as_size_t() / 256;
+      const auto last = (s1 - theBlock.start).as_size_t() - 1;
+      const auto nFrames = last / 256 - first + 1;
+      if (read256 && theFile->Read256(summary.get(), first, nFrames)) {
+         for (size_t i = 0; i < nFrames; ++i) {
+            const auto frameStart = theBlock.start + (first + i) * 256;
+            const auto f0 = std::max(s0, frameStart);
+            const auto f1 = std::min(s1, frameStart + 256);
+            if (!add(f0, f1 - f0,
+                     ruledIn(summary[3 * i], summary[3 * i + 1])))
+               return false;
+         }
+      }
+      // Without summaries, the samples must be read
+      else if (!add(s0, s1 - s0, false))
+         return false;
+   }
+
+   return flush();
+}
+
 std::unique_ptr<Sequence> Sequence::Copy(sampleCount s0, sampleCount s1) const
 {
    auto dest = std::make_unique<Sequence>(mDirManager, mSampleFormat);
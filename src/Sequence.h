@@ -12,6 +12,7 @@
 #define __AUDACITY_SEQUENCE__
 
 #include "MemoryX.h"
+#include <functional>
 #include <vector>
 #include <wx/string.h>
 
@@ -174,6 +175,23 @@ class PROFILE_DLL_API Sequence final : public XMLTagHandler{
       sampleCount start, sampleCount len, bool mayThrow) const;
    float GetRMS(sampleCount start, sampleCount len, bool mayThrow) const;
 
+   // Given the least and greatest of some samples, return true if that is
+   // enough to know that every one of them meets the condition of a scan.
+   // It must also hold for any narrower range of values.
+   using SummaryPredicate = std::function< bool(float min, float max) >;
+   // Receives the samples of a scan in order, a run at a time.  samples is
+   // null for a run that the predicate ruled in, which was not read; else
+   // it holds len samples.  Return false to end the scan.
+   using SummaryVisitor = std::function<
+      bool(sampleCount start, sampleCount len, const float *samples) >;
+
+   // Visits the samples from start through start + len - 1, reading only
+   // those that the min and max of whole blocks, and then of the 256-sample
+   // summaries, cannot rule in.  Returns false if visit ended the scan.
+   bool ScanWithSummaries(sampleCount start, sampleCount len,
+      const SummaryPredicate &ruledIn, const SummaryVisitor &visit,
+      bool mayThrow) const;
+
    //
    // Getting block size and alignment information
    //
@@ -0,0 +1,87 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  StartupProfiler.cpp
+
+********************************************************************//**
+
+\class StartupProfiler
+\brief Collects the elapsed time of each named phase of
+AudacityApp::OnInit() and of the work it defers until the main window
+is up, and writes them as a plain text report when Audacity is started
+with --startup-profile.
+
+*//********************************************************************/
+
+#include "Audacity.h"
+#include "StartupProfiler.h"
+
+#include <wx/ffile.h>
+#include <wx/log.h>
+
+StartupProfiler::Phase::Phase(const wxString &name)
+   : mIndex{ StartupProfiler::Get().Begin(name) }
+{
+}
+
+StartupProfiler::Phase::~Phase()
+{
+   StartupProfiler::Get().End(mIndex);
+}
+
+StartupProfiler &StartupProfiler::Get()
+{
+   static StartupProfiler profiler;
+   return profiler;
+}
+
+StartupProfiler::StartupProfiler()
+{
+   mWatch.Start();
+}
+
+size_t StartupProfiler::Begin(const wxString &name)
+{
+   mRecords.push_back({ name, mDepth++, mWatch.Time(), -1 });
+   return mRecords.size() - 1;
+}
+
+void StartupProfiler::End(size_t index)
+{
+   auto &record = mRecords[index];
+   record.duration = mWatch.Time() - record.start;
+   --mDepth;
+}
+
+void StartupProfiler::WriteReport()
+{
+   if (mReportFile.empty())
+      return;
+
+   wxFFile file;
+   if (!file.Open(mReportFile, wxT("w")))
+   {
+      wxLogError(wxT("Could not write startup profile to %s"), mReportFile);
+      mReportFile.clear();
+      return;
+   }
+
+   file.Write(wxString::Format(wxT("%8s %8s  %s\n"),
+      wxT("start"), wxT("ms"), wxT("phase")));
+   for (const auto &record : mRecords)
+   {
+      file.Write(wxString::Format(wxT("%8ld %8ld  %s%s\n"),
+         record.start,
+         record.duration,
+         wxString(wxT(' '), 2 * record.depth),
+         record.name));
+   }
+   file.Write(wxString::Format(wxT("%8ld %8s  %s\n"),
+      mWatch.Time(), wxT(""), wxT("total")));
+
+   file.Close();
+
+   // Only the first report is of interest
+   mReportFile.clear();
+}
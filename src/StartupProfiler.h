@@ -0,0 +1,65 @@
+/**********************************************************************
+
+  Audacity: A Digital Audio Editor
+
+  StartupProfiler.h
+
+  Records how long each phase of application start-up takes.
+
+**********************************************************************/
+
+#ifndef __AUDACITY_STARTUP_PROFILER__
+#define __AUDACITY_STARTUP_PROFILER__
+
+#include "Audacity.h"
+
+#include <vector>
+#include <wx/stopwatch.h>
+#include <wx/string.h>
+
+class AUDACITY_DLL_API StartupProfiler
+{
+public:
+   // Timing a phase costs one stopwatch read at each end, so phases are
+   // always recorded; the report is written only if a file was requested.
+   class Phase
+   {
+   public:
+      explicit Phase(const wxString &name);
+      ~Phase();
+
+      Phase(const Phase&) = delete;
+      Phase &operator= (const Phase&) = delete;
+
+   private:
+      size_t mIndex;
+   };
+
+   static StartupProfiler &Get();
+
+   // Write the report to this file when WriteReport() is next called
+   void SetReportFile(const wxString &fileName) { mReportFile = fileName; }
+
+   // Called once the deferred start-up work has also completed
+   void WriteReport();
+
+private:
+   StartupProfiler();
+
+   struct Record {
+      wxString name;
+      int depth;
+      long start;
+      long duration;
+   };
+
+   size_t Begin(const wxString &name);
+   void End(size_t index);
+
+   wxStopWatch mWatch;
+   std::vector<Record> mRecords;
+   int mDepth{ 0 };
+   wxString mReportFile;
+};
+
+#endif
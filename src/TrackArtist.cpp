@@ -2847,8 +2847,6 @@ void TrackArt::DrawNoteTrack(TrackPanelDrawingContext &context,
    const double h = X_TO_TIME(rect.x);
    const double h1 = X_TO_TIME(rect.x + rect.width);
 
-   Alg_seq_ptr seq = &track->GetSeq();
-
    if (!track->GetSelected())
       sel0 = sel1 = 0.0;
 
@@ -2919,40 +2917,35 @@ void TrackArt::DrawNoteTrack(TrackPanelDrawingContext &context,
    SonifyBeginNoteForeground();
    int marg = track->GetNoteMargin(rect.height);
 
-   // NOTE: it would be better to put this in some global initialization
-   // function rather than do lookups every time.
-   Alg_attribute line = symbol_table.insert_string("line");
-   Alg_attribute rectangle = symbol_table.insert_string("rectangle");
-   Alg_attribute triangle = symbol_table.insert_string("triangle");
-   Alg_attribute polygon = symbol_table.insert_string("polygon");
-   Alg_attribute oval = symbol_table.insert_string("oval");
-   Alg_attribute text = symbol_table.insert_string("text");
-   Alg_attribute texts = symbol_table.insert_string("texts");
-   Alg_attribute x1r = symbol_table.insert_string("x1r");
-   Alg_attribute x2r = symbol_table.insert_string("x2r");
-   Alg_attribute y1r = symbol_table.insert_string("y1r");
-   Alg_attribute y2r = symbol_table.insert_string("y2r");
-   Alg_attribute linecolori = symbol_table.insert_string("linecolori");
-   Alg_attribute fillcolori = symbol_table.insert_string("fillcolori");
-   Alg_attribute linethicki = symbol_table.insert_string("linethicki");
-   Alg_attribute filll = symbol_table.insert_string("filll");
-   Alg_attribute fonta = symbol_table.insert_string("fonta");
-   Alg_attribute roman = symbol_table.insert_string("roman");
-   Alg_attribute swiss = symbol_table.insert_string("swiss");
-   Alg_attribute modern = symbol_table.insert_string("modern");
-   Alg_attribute weighta = symbol_table.insert_string("weighta");
-   Alg_attribute bold = symbol_table.insert_string("bold");
-   Alg_attribute sizei = symbol_table.insert_string("sizei");
-   Alg_attribute justifys = symbol_table.insert_string("justifys");
-
-   // We want to draw in seconds, so we need to convert to seconds
-   seq->convert_to_seconds();
-
-   Alg_iterator iterator(seq, false);
-   iterator.begin();
-   //for every event
-   Alg_event_ptr evt;
-   while (0 != (evt = iterator.next())) {
+   // The symbol table keeps its strings for the life of the program, so
+   // look these up only once.
+   static const Alg_attribute line = symbol_table.insert_string("line");
+   static const Alg_attribute rectangle = symbol_table.insert_string("rectangle");
+   static const Alg_attribute triangle = symbol_table.insert_string("triangle");
+   static const Alg_attribute polygon = symbol_table.insert_string("polygon");
+   static const Alg_attribute oval = symbol_table.insert_string("oval");
+   static const Alg_attribute text = symbol_table.insert_string("text");
+   static const Alg_attribute texts = symbol_table.insert_string("texts");
+   static const Alg_attribute x1r = symbol_table.insert_string("x1r");
+   static const Alg_attribute x2r = symbol_table.insert_string("x2r");
+   static const Alg_attribute y1r = symbol_table.insert_string("y1r");
+   static const Alg_attribute y2r = symbol_table.insert_string("y2r");
+   static const Alg_attribute linecolori = symbol_table.insert_string("linecolori");
+   static const Alg_attribute fillcolori = symbol_table.insert_string("fillcolori");
+   static const Alg_attribute linethicki = symbol_table.insert_string("linethicki");
+   static const Alg_attribute filll = symbol_table.insert_string("filll");
+   static const Alg_attribute fonta = symbol_table.insert_string("fonta");
+   static const Alg_attribute roman = symbol_table.insert_string("roman");
+   static const Alg_attribute swiss = symbol_table.insert_string("swiss");
+   static const Alg_attribute modern = symbol_table.insert_string("modern");
+   static const Alg_attribute weighta = symbol_table.insert_string("weighta");
+   static const Alg_attribute bold = symbol_table.insert_string("bold");
+   static const Alg_attribute sizei = symbol_table.insert_string("sizei");
+   static const Alg_attribute justifys = symbol_table.insert_string("justifys");
+
+   // The track keeps its notes sorted by time, in seconds, so visit only
+   // those that may be in view
+   for (const auto evt : track->NotesNear(h, h1)) {
       if (evt->get_type() == 'n') { // 'n' means a note
          Alg_note_ptr note = (Alg_note_ptr) evt;
          // if the note's channel is visible
@@ -3178,7 +3171,6 @@ void TrackArt::DrawNoteTrack(TrackPanelDrawingContext &context,
          }
       }
    }
-   iterator.end();
    // draw black line between top/bottom margins and the track
    dc.SetPen(*wxBLACK_PEN);
    AColor::Line(dc, rect.x, rect.y + marg, rect.x + rect.width, rect.y + marg);
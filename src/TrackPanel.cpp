@@ -643,9 +643,31 @@ bool TrackPanel::TakesFocus() const
 
 void TrackPanel::UpdateSelectionDisplay()
 {
-   // Full refresh since the label area may need to indicate
-   // newly selected tracks.
-   Refresh(false);
+   // Only the teams that show the time selection, now or as last drawn,
+   // need their backing redrawn.  That includes their label areas, which
+   // may need to indicate newly selected tracks.
+   wxRect dirty;
+   const auto addTeam = [&](const Track *leader) {
+      const auto rect = FindTeamRefreshRect(leader);
+      dirty = dirty.IsEmpty() ? rect : dirty.Union(rect);
+   };
+   for (auto leader : GetTracks()->Leaders())
+      if (IsSelectionSensitive(leader))
+         addTeam(leader);
+   for (const auto &pTrack : mLastDrawnSelectionSensitive) {
+      const auto leader = pTrack.lock();
+      if (leader && leader->GetOwner().get() == GetTracks())
+         addTeam(leader.get());
+   }
+
+   dirty.Intersect(wxRect{ GetSize() });
+   if (dirty.IsEmpty())
+      // Nothing on screen depends on the selection
+      mLastDrawnSelectedRegion = mViewInfo->selectedRegion;
+   else {
+      mRefreshBacking = true;
+      Refresh(false, &dirty);
+   }
 
    // Make sure the ruler follows suit.
    mRuler->DrawSelection();
@@ -994,16 +1016,7 @@ void TrackPanel::RefreshTrack(Track *trk, bool refreshbacking)
       return;
 
    trk = *GetTracks()->FindLeader(trk);
-   auto height =
-      TrackList::Channels(trk).sum( &Track::GetHeight )
-      - kTopInset - kShadowThickness;
-
-   // subtract insets and shadows from the rectangle, but not border
-   // This matters because some separators do paint over the border
-   wxRect rect(kLeftInset,
-            -mViewInfo->vpos + trk->GetY() + kTopInset,
-            GetRect().GetWidth() - kLeftInset - kRightInset - kShadowThickness,
-            height);
+   const auto rect = FindTeamRefreshRect(trk);
 
    if( refreshbacking )
    {
@@ -1013,6 +1026,30 @@ void TrackPanel::RefreshTrack(Track *trk, bool refreshbacking)
    Refresh( false, &rect );
 }
 
+wxRect TrackPanel::FindTeamRefreshRect(const Track *leader) const
+{
+   auto height =
+      TrackList::Channels(leader).sum( &Track::GetHeight )
+      - kTopInset - kShadowThickness;
+
+   // subtract insets and shadows from the rectangle, but not border
+   // This matters because some separators do paint over the border
+   return wxRect(kLeftInset,
+            -mViewInfo->vpos + leader->GetY() + kTopInset,
+            GetRect().GetWidth() - kLeftInset - kRightInset - kShadowThickness,
+            height);
+}
+
+bool TrackPanel::IsSelectionSensitive(const Track *leader)
+{
+   // TrackArtist shows the selection only in selected or sync-lock
+   // selected tracks, and the label area shows only the selected state
+   return TrackList::Channels(leader).any_of(
+      [](const Track *channel) {
+         channel = channel->SubstitutePendingChangedTrack().get();
+         return channel->IsSelectedOrSyncLockSelected();
+      } );
+}
 
 /// This method overrides Refresh() of wxWindow so that the
 /// boolean play indictaor can be set to false, so that an old play indicator that is
@@ -1083,6 +1120,20 @@ void TrackPanel::DrawTracks(wxDC * dc)
    mTrackArtist->hasSolo = hasSolo;
    TrackArt::DrawTracks( context, GetTracks(), region, clip );
 
+   // Remember which teams now show the selection in the backing bitmap.
+   // After a partial redraw, those not repainted keep what they showed.
+   if (region.GetBox() == clip)
+      mLastDrawnSelectionSensitive.clear();
+   for (auto leader : GetTracks()->Leaders()) {
+      if (!IsSelectionSensitive(leader))
+         continue;
+      const auto pTrack = leader->FindTrack();
+      const auto end = mLastDrawnSelectionSensitive.end();
+      if (end == std::find_if(mLastDrawnSelectionSensitive.begin(), end,
+         [&](const std::weak_ptr<Track> &p){ return p.lock() == pTrack; }))
+         mLastDrawnSelectionSensitive.push_back(pTrack);
+   }
+
    // Draw the rest, including the click-to-deselect blank area below all
    // tracks
    DrawEverythingElse(context, region, clip);
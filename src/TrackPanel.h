@@ -330,6 +330,11 @@ public:
 
 protected:
    void UpdateSelectionDisplay();
+   // Rectangle of a team of channels as RefreshTrack() invalidates it
+   wxRect FindTeamRefreshRect(const Track *leader) const;
+   // True if the drawing of any channel of the team shows the time
+   // selection, so that it must be redrawn when only the selection changes
+   static bool IsSelectionSensitive(const Track *leader);
 
 public:
    void UpdateAccessibility();
@@ -472,6 +477,8 @@ protected:
    friend class ScreenshotCommand;
 
    SelectedRegion mLastDrawnSelectedRegion {};
+   // Teams whose drawing in the backing bitmap shows the time selection
+   std::vector< std::weak_ptr<Track> > mLastDrawnSelectionSensitive;
 
  public:
    wxSize vrulerSize;
@@ -297,6 +297,35 @@ static void ComputeSpectrumUsingRealFFTf
    }
 }
 
+void WaveClip::SetLayoutGeneration(
+   const std::shared_ptr<LayoutGeneration> &generation)
+{
+   mLayoutGeneration = generation;
+   LayoutChanged();
+}
+
+void WaveClip::LayoutChanged()
+{
+   // Clips may be lengthened on the recording thread while the main thread
+   // looks up clips in the same track, so the counter is atomic
+   if (mLayoutGeneration)
+      mLayoutGeneration->fetch_add(1, std::memory_order_acq_rel);
+}
+
+void WaveClip::MarkChanged()
+// NOFAIL-GUARANTEE
+{
+   mDirty++;
+
+   // Rewriting samples in place leaves the layout alone; only a change of
+   // length moves the end of the clip
+   const auto numSamples = mSequence->GetNumSamples();
+   if (numSamples != mMarkedNumSamples) {
+      mMarkedNumSamples = numSamples;
+      LayoutChanged();
+   }
+}
+
 WaveClip::WaveClip(const std::shared_ptr<DirManager> &projDirManager,
                    sampleFormat format, int rate, int colourIndex)
 {
@@ -394,6 +423,7 @@ void WaveClip::SetOffset(double offset)
 {
     mOffset = offset;
     mEnvelope->SetOffset(mOffset);
+    LayoutChanged();
 }
 
 bool WaveClip::GetSamples(samplePtr buffer, sampleFormat format,
@@ -485,6 +515,9 @@ void WaveClip::AddInvalidRegion(sampleCount startSample, sampleCount endSample)
 
 namespace {
 
+// How many screen widths of columns the wave cache may keep
+enum : int { kWaveCacheScreens = 3 };
+
 inline
 void findCorrection(const std::vector<sampleCount> &oldWhere, size_t oldLen,
          size_t newLen,
@@ -556,6 +589,7 @@ bool WaveClip::GetWaveDisplay(WaveDisplay &display, double t0,
 
    size_t p0 = 0;         // least column requiring computation
    size_t p1 = numPixels; // greatest column requiring computation, plus one
+   size_t viewX0 = 0;     // first requested column
 
    float *min;
    float *max;
@@ -582,7 +616,8 @@ bool WaveClip::GetWaveDisplay(WaveDisplay &display, double t0,
       // accumulated difference of times over the number of pixels is less than
       // a sample period.
       const bool ppsMatch = mWaveCache &&
-         (fabs(tstep - 1.0 / mWaveCache->pps) * numPixels < (1.0 / mRate));
+         (fabs(tstep - 1.0 / mWaveCache->pps) *
+            std::max(numPixels, mWaveCache->len) < (1.0 / mRate));
 
       const bool match =
          mWaveCache &&
@@ -590,55 +625,86 @@ bool WaveClip::GetWaveDisplay(WaveDisplay &display, double t0,
          mWaveCache->len > 0 &&
          mWaveCache->dirty == mDirty;
 
+      // Where does our first pixel fall in the columns of the old cache?
+      int oldX0 = 0;
+      double correction = 0.0;
+      if (match) {
+         if (mWaveCache->start == t0)
+            oldX0 = 0;
+         else
+            findCorrection(mWaveCache->where, mWaveCache->len, numPixels,
+               t0, mRate, samplesPerPixel,
+               oldX0, correction);
+      }
+
       if (match &&
-         mWaveCache->start == t0 &&
-         mWaveCache->len >= numPixels) {
+         oldX0 >= 0 &&
+         oldX0 + numPixels <= mWaveCache->len) {
          mWaveCache->LoadInvalidRegions(mSequence.get(), true);
          mWaveCache->ClearInvalidRegions();
 
-         // Satisfy the request completely from the cache
-         display.min = &mWaveCache->min[0];
-         display.max = &mWaveCache->max[0];
-         display.rms = &mWaveCache->rms[0];
-         display.bl = &mWaveCache->bl[0];
-         display.where = &mWaveCache->where[0];
+         // Satisfy the request completely from the cache, which may hold
+         // columns on either side of those requested
+         display.min = &mWaveCache->min[oldX0];
+         display.max = &mWaveCache->max[oldX0];
+         display.rms = &mWaveCache->rms[oldX0];
+         display.bl = &mWaveCache->bl[oldX0];
+         display.where = &mWaveCache->where[oldX0];
          isLoadingOD = mWaveCache->numODPixels > 0;
          return true;
       }
 
       std::unique_ptr<WaveCache> oldCache(std::move(mWaveCache));
 
-      int oldX0 = 0;
-      double correction = 0.0;
+      // The new cache spans the requested columns and, so that scrolling
+      // back and forth recomputes nothing, as many of the old ones as fit in
+      // a few screen widths.  lo and hi are columns of the old cache.
+      int lo = oldX0, hi = oldX0 + (int)numPixels;
       size_t copyBegin = 0, copyEnd = 0;
-      if (match) {
-         findCorrection(oldCache->where, oldCache->len, numPixels,
-            t0, mRate, samplesPerPixel,
-            oldX0, correction);
-         // Remember our first pixel maps to oldX0 in the old cache,
-         // possibly out of bounds.
-         // For what range of pixels can data be copied?
-         copyBegin = std::min<size_t>(numPixels, std::max(0, -oldX0));
-         copyEnd = std::min<size_t>(numPixels, std::max(0,
-            (int)oldCache->len - oldX0
-         ));
+      if (match && oldX0 < (int)oldCache->len && hi > 0) {
+         const int maxLen = kWaveCacheScreens * numPixels;
+         if (oldX0 > 0)
+            // Scrolled right; keep old columns to the left
+            lo = std::max(0, hi - maxLen);
+         else
+            hi = std::min((int)oldCache->len, oldX0 + maxLen);
+         hi = std::max(hi, oldX0 + (int)numPixels);
+
+         // For what range of new columns can data be copied?
+         copyBegin = std::max(0, -lo);
+         copyEnd = std::min(hi, (int)oldCache->len) - lo;
+
+         // Widening on both sides (the window grew) is not worth the
+         // bookkeeping; start afresh
+         if (copyBegin > 0 && copyEnd < size_t(hi - lo))
+            copyEnd = copyBegin;
       }
-      if (!(copyEnd > copyBegin))
+      if (!(copyEnd > copyBegin)) {
          oldCache.reset(0);
+         oldX0 = lo = 0;
+         hi = numPixels;
+         correction = 0.0;
+         copyBegin = copyEnd = 0;
+      }
 
-      mWaveCache = std::make_unique<WaveCache>(numPixels, pixelsPerSecond, mRate, t0, mDirty);
+      const size_t len = hi - lo;
+      // Offset of the requested columns in the new cache
+      viewX0 = oldX0 - lo;
+      const double start = t0 - viewX0 * tstep;
+
+      mWaveCache = std::make_unique<WaveCache>(len, pixelsPerSecond, mRate, start, mDirty);
       min = &mWaveCache->min[0];
       max = &mWaveCache->max[0];
       rms = &mWaveCache->rms[0];
       bl = &mWaveCache->bl[0];
       pWhere = &mWaveCache->where;
 
-      fillWhere(*pWhere, numPixels, 0.0, correction,
-         t0, mRate, samplesPerPixel);
+      fillWhere(*pWhere, len, 0.0, correction,
+         start, mRate, samplesPerPixel);
 
       // The range of pixels we must fetch from the Sequence:
       p0 = (copyBegin > 0) ? 0 : copyEnd;
-      p1 = (copyEnd >= numPixels) ? copyBegin : numPixels;
+      p1 = (copyEnd >= len) ? copyBegin : len;
 
       // Optimization: if the old cache is good and overlaps
       // with the current one, re-use as much of the cache as
@@ -655,7 +721,7 @@ bool WaveClip::GetWaveDisplay(WaveDisplay &display, double t0,
          // Copy what we can from the old cache.
          const int length = copyEnd - copyBegin;
          const size_t sizeFloats = length * sizeof(float);
-         const int srcIdx = (int)copyBegin + oldX0;
+         const int srcIdx = (int)copyBegin + lo;
          memcpy(&min[copyBegin], &oldCache->min[srcIdx], sizeFloats);
          memcpy(&max[copyBegin], &oldCache->max[srcIdx], sizeFloats);
          memcpy(&rms[copyBegin], &oldCache->rms[srcIdx], sizeFloats);
@@ -756,11 +822,11 @@ bool WaveClip::GetWaveDisplay(WaveDisplay &display, double t0,
    //find the number of OD pixels - the only way to do this is by recounting
    if (!allocated) {
       // Now report the results
-      display.min = min;
-      display.max = max;
-      display.rms = rms;
-      display.bl = bl;
-      display.where = &(*pWhere)[0];
+      display.min = min + viewX0;
+      display.max = max + viewX0;
+      display.rms = rms + viewX0;
+      display.bl = bl + viewX0;
+      display.where = &(*pWhere)[viewX0];
       isLoadingOD = mWaveCache->numODPixels > 0;
    }
    else {
@@ -1538,8 +1604,11 @@ bool WaveClip::HandleXMLTag(const wxChar *tag, const wxChar **attrs)
 
 void WaveClip::HandleXMLEndTag(const wxChar *tag)
 {
-   if (!wxStrcmp(tag, wxT("waveclip")))
+   if (!wxStrcmp(tag, wxT("waveclip"))) {
       UpdateEnvelopeTrackLen();
+      // The sequence was read without going through MarkChanged()
+      LayoutChanged();
+   }
 }
 
 XMLTagHandler *WaveClip::HandleXMLChild(const wxChar *tag)
@@ -1893,6 +1962,7 @@ void WaveClip::SetRate(int rate)
    auto newLength = mSequence->GetNumSamples().as_double() / mRate;
    mEnvelope->RescaleTimes( newLength );
    MarkChanged();
+   LayoutChanged();
 }
 
 void WaveClip::Resample(int rate, ProgressDialog *progress)
@@ -1977,6 +2047,7 @@ void WaveClip::Resample(int rate, ProgressDialog *progress)
 
       mSequence = std::move(newSequence);
       mRate = rate;
+      LayoutChanged();
    }
 }
 
@@ -25,6 +25,7 @@
 #include <wx/gdicmn.h>
 #include <wx/longlong.h>
 
+#include <atomic>
 #include <vector>
 
 class BlockArray;
@@ -252,8 +253,16 @@ public:
    /** WaveTrack calls this whenever data in the wave clip changes. It is
     * called automatically when WaveClip has a chance to know that something
     * has changed, like when member functions SetSamples() etc. are called. */
-   void MarkChanged() // NOFAIL-GUARANTEE
-      { mDirty++; }
+   void MarkChanged(); // NOFAIL-GUARANTEE
+
+   /** The owning WaveTrack counts changes to the offset, length or rate of
+    * its clips, and compares the count with the value it saw when it last
+    * sorted them by time.  The clip holds no counter while it belongs to no
+    * track. */
+   using LayoutGeneration = std::atomic<unsigned long>;
+   void SetLayoutGeneration(
+      const std::shared_ptr<LayoutGeneration> &generation); // NOFAIL-GUARANTEE
+   void LayoutChanged(); // NOFAIL-GUARANTEE
 
    /** Getting high-level data for screen display and clipping
     * calculations and Contrast */
@@ -374,6 +383,8 @@ protected:
    double mOffset { 0 };
    int mRate;
    int mDirty { 0 };
+   sampleCount mMarkedNumSamples { 0 };
+   std::shared_ptr<LayoutGeneration> mLayoutGeneration;
    int mColourIndex;
 
    std::unique_ptr<Sequence> mSequence;
@@ -142,8 +142,7 @@ WaveTrack::WaveTrack(const WaveTrack &orig):
    Init(orig);
 
    for (const auto &clip : orig.mClips)
-      mClips.push_back
-         ( std::make_unique<WaveClip>( *clip, mDirManager, true ) );
+      InsertClip( std::make_unique<WaveClip>( *clip, mDirManager, true ) );
 }
 
 // Copy the track metadata but not the contents.
@@ -646,9 +645,8 @@ Track::Holder WaveTrack::Copy(double t0, double t1, bool forClipboard) const
          // Whole clip is in copy region
          //wxPrintf("copy: clip %i is in copy region\n", (int)clip);
 
-         newTrack->mClips.push_back
+         WaveClip *const newClip = newTrack->InsertClip
             (std::make_unique<WaveClip>(*clip, mDirManager, ! forClipboard));
-         WaveClip *const newClip = newTrack->mClips.back().get();
          newClip->Offset(-t0);
       }
       else if (t1 > clip->GetStartTime() && t0 < clip->GetEndTime())
@@ -668,7 +666,7 @@ Track::Holder WaveTrack::Copy(double t0, double t1, bool forClipboard) const
          if (newClip->GetOffset() < 0)
             newClip->SetOffset(0);
 
-         newTrack->mClips.push_back(std::move(newClip)); // transfer ownership
+         newTrack->InsertClip(std::move(newClip)); // transfer ownership
       }
    }
 
@@ -686,7 +684,7 @@ Track::Holder WaveTrack::Copy(double t0, double t1, bool forClipboard) const
       placeholder->SetIsPlaceholder(true);
       placeholder->InsertSilence(0, (t1 - t0) - newTrack->GetEndTime());
       placeholder->Offset(newTrack->GetEndTime());
-      newTrack->mClips.push_back(std::move(placeholder)); // transfer ownership
+      newTrack->InsertClip(std::move(placeholder)); // transfer ownership
    }
 
    return result;
@@ -1013,11 +1011,8 @@ std::shared_ptr<WaveClip> WaveTrack::RemoveAndReturnClip(WaveClip* clip)
 {
    // Be clear about who owns the clip!!
    auto it = FindClip(mClips, clip);
-   if (it != mClips.end()) {
-      auto result = std::move(*it); // Array stops owning the clip, before we shrink it
-      mClips.erase(it);
-      return result;
-   }
+   if (it != mClips.end())
+      return EraseClip(it);
    else
       return {};
 }
@@ -1026,7 +1021,26 @@ void WaveTrack::AddClip(std::shared_ptr<WaveClip> &&clip)
 {
    // Uncomment the following line after we correct the problem of zero-length clips
    //if (CanInsertClip(clip))
-      mClips.push_back(std::move(clip)); // transfer ownership
+      InsertClip(std::move(clip)); // transfer ownership
+}
+
+WaveClip *WaveTrack::InsertClip(WaveClipHolder clip)
+// NOFAIL-GUARANTEE
+{
+   mClips.push_back(std::move(clip)); // transfer ownership
+   const auto result = mClips.back().get();
+   result->SetLayoutGeneration(mLayoutGeneration);
+   return result;
+}
+
+WaveClipHolder WaveTrack::EraseClip(WaveClipHolders::iterator it)
+// NOFAIL-GUARANTEE
+{
+   auto result = std::move(*it); // Array stops owning the clip, before we shrink it
+   mClips.erase(it);
+   result->SetLayoutGeneration({});
+   mLayoutGeneration->fetch_add(1, std::memory_order_acq_rel);
+   return result;
 }
 
 void WaveTrack::HandleClear(double t0, double t1,
@@ -1157,13 +1171,13 @@ void WaveTrack::HandleClear(double t0, double t1,
    {
       auto myIt = FindClip(mClips, clip);
       if (myIt != mClips.end())
-         mClips.erase(myIt); // deletes the clip!
+         EraseClip(myIt); // deletes the clip!
       else
          wxASSERT(false);
    }
 
    for (auto &clip: clipsToAdd)
-      mClips.push_back(std::move(clip)); // transfer ownership
+      InsertClip(std::move(clip)); // transfer ownership
 }
 
 void WaveTrack::SyncLockAdjust(double oldT1, double newT1)
@@ -1358,7 +1372,7 @@ void WaveTrack::Paste(double t0, const Track *src)
             newClip->Resample(mRate);
             newClip->Offset(t0);
             newClip->MarkChanged();
-            mClips.push_back(std::move(newClip)); // transfer ownership
+            InsertClip(std::move(newClip)); // transfer ownership
          }
       }
       return true;
@@ -1419,7 +1433,7 @@ void WaveTrack::InsertSilence(double t, double len)
       auto clip = std::make_unique<WaveClip>(mDirManager, mFormat, mRate, this->GetWaveColorIndex());
       clip->InsertSilence(0, len);
       // use NOFAIL-GUARANTEE
-      mClips.push_back( std::move( clip ) );
+      InsertClip( std::move( clip ) );
       return;
    }
    else {
@@ -1571,7 +1585,7 @@ void WaveTrack::Join(double t0, double t1)
       t = newClip->GetEndTime();
 
       auto it = FindClip(mClips, clip);
-      mClips.erase(it); // deletes the clip
+      EraseClip(it); // deletes the clip
    }
 }
 
@@ -1911,6 +1925,109 @@ double WaveTrack::GetEndTime() const
    return best;
 }
 
+//
+// Index of clips by time
+//
+
+namespace {
+   template < typename Cont1, typename Cont2 >
+   Cont1 FillSortedClipArray(const Cont2& mClips)
+   {
+      Cont1 clips;
+      for (const auto &clip : mClips)
+         clips.push_back(clip.get());
+      std::sort(clips.begin(), clips.end(),
+         [](const WaveClip *a, const WaveClip *b)
+      { return a->GetStartTime() < b->GetStartTime(); });
+      return clips;
+   }
+}
+
+struct WaveTrack::ClipIndex
+{
+   using Iterator = WaveClipPointers::const_iterator;
+
+   struct Range {
+      Iterator first, last;
+      Iterator begin() const { return first; }
+      Iterator end() const { return last; }
+   };
+
+   // Clips that may intersect the samples from s0 through s1, in time
+   // order.  The range may hold a clip more than needed at either end, so
+   // callers still test each clip.
+   Range Near(sampleCount s0, sampleCount s1) const
+   {
+      const auto begin = clips.begin(), end = clips.end();
+      if (unordered)
+         return { begin, end };
+
+      // Clips do not overlap, so their ends are in the same order as
+      // their starts
+      auto first = std::partition_point(begin, end,
+         [&](const WaveClip *clip){ return clip->GetEndSample() < s0; });
+      auto last = std::partition_point(first, end,
+         [&](const WaveClip *clip){ return clip->GetStartSample() <= s1; });
+
+      // Times round to samples, and GetEndTime() counts samples still in
+      // the append buffer; one more clip at each end covers both
+      if (first != begin)
+         --first;
+      if (last != end)
+         ++last;
+      return { first, last };
+   }
+
+   Range Near(double t0, double t1, double rate) const
+   {
+      return Near(sampleCount( floor(t0 * rate) ) - 1,
+                  sampleCount( ceil(t1 * rate) ) + 1);
+   }
+
+   unsigned long generation;
+   int rate;
+   WaveClipPointers clips;
+
+   // True if any clips overlap, or differ in rate from the track after an
+   // incomplete resample.  Then searches give up and visit every clip.
+   bool unordered;
+};
+
+auto WaveTrack::GetClipTimeIndex() const -> std::shared_ptr<const ClipIndex>
+{
+   // Read the generation first, so that a change made while we sort is
+   // seen next time
+   const auto generation =
+      mLayoutGeneration->load(std::memory_order_acquire);
+
+   auto index = std::atomic_load(&mClipIndex);
+   if (index &&
+       index->generation == generation &&
+       index->rate == mRate &&
+       index->clips.size() == mClips.size())
+      return index;
+
+   auto newIndex = std::make_shared<ClipIndex>();
+   newIndex->generation = generation;
+   newIndex->rate = mRate;
+   newIndex->clips = FillSortedClipArray<WaveClipPointers>(mClips);
+   newIndex->unordered = false;
+
+   const WaveClip *prev = nullptr;
+   for (const auto clip : newIndex->clips) {
+      if (clip->GetRate() != mRate ||
+          (prev && clip->GetStartSample() < prev->GetEndSample())) {
+         newIndex->unordered = true;
+         break;
+      }
+      prev = clip;
+   }
+
+   index = newIndex;
+   std::atomic_store(&mClipIndex, index);
+   return index;
+}
+
 //
 // Getting/setting samples.  The sample counts here are
 // expressed relative to t=0.0 at the track's sample rate.
@@ -1934,7 +2051,8 @@ std::pair<float, float> WaveTrack::GetMinMax(
    if (t0 == t1)
       return results;
 
-   for (const auto &clip: mClips)
+   const auto index = GetClipTimeIndex();
+   for (const auto clip: index->Near(t0, t1, mRate))
    {
       if (t1 >= clip->GetStartTime() && t0 <= clip->GetEndTime())
       {
@@ -1969,7 +2087,8 @@ float WaveTrack::GetRMS(double t0, double t1, bool mayThrow) const
    double sumsq = 0.0;
    sampleCount length = 0;
 
-   for (const auto &clip: mClips)
+   const auto index = GetClipTimeIndex();
+   for (const auto clip: index->Near(t0, t1, mRate))
    {
       // If t1 == clip->GetStartTime() or t0 == clip->GetEndTime(), then the clip
       // is not inside the selection, so we don't want it.
@@ -1989,6 +2108,72 @@ float WaveTrack::GetRMS(double t0, double t1, bool mayThrow) const
    return length > 0 ? sqrt(sumsq / length.as_double()) : 0.0;
 }
 
+bool WaveTrack::ScanWithSummaries(sampleCount start, sampleCount len,
+   const Sequence::SummaryPredicate &ruledIn,
+   const Sequence::SummaryVisitor &visit,
+   bool mayThrow) const
+{
+   const auto end = start + len;
+   const auto blockSize = GetMaxBlockSize();
+   Floats buffer;
+
+   // Visit samples from pos up to to as Get() finds them
+   auto pos = start;
+   auto visitByGet = [&](sampleCount to) -> bool {
+      if (!buffer)
+         buffer.reinit(blockSize);
+      for (; pos < to;) {
+         const auto count = limitSampleBufferSize(blockSize, to - pos);
+         Get((samplePtr)buffer.get(), floatSample, pos, count,
+             fillZero, mayThrow);
+         if (!visit(pos, count, buffer.get()))
+            return false;
+         pos += count;
+      }
+      return true;
+   };
+   // Visit the zeroes between clips
+   auto visitGap = [&](sampleCount to) -> bool {
+      if (pos >= to)
+         return true;
+      if (!ruledIn(0.0f, 0.0f))
+         return visitByGet(to);
+      const auto gapStart = pos;
+      pos = to;
+      return visit(gapStart, to - gapStart, nullptr);
+   };
+
+   const auto index = GetClipTimeIndex();
+   if (index->unordered)
+      // Overlapping clips; let Get() sort them out
+      return visitByGet(end);
+
+   for (const auto clip : index->Near(start, end)) {
+      const auto clipStart = clip->GetStartSample();
+      const auto clipEnd = std::min(end, clip->GetEndSample());
+      if (clipEnd <= pos)
+         continue;
+      if (clipStart >= end)
+         break;
+
+      if (!visitGap(clipStart))
+         return false;
+
+      const auto from = pos;
+      pos = clipEnd;
+      if (!clip->GetSequence()->ScanWithSummaries(
+            from - clipStart, clipEnd - from, ruledIn,
+            [&](sampleCount runStart, sampleCount runLen,
+                const float *samples) {
+               return visit(runStart + clipStart, runLen, samples);
+            },
+            mayThrow))
+         return false;
+   }
+
+   return visitGap(end);
+}
+
 bool WaveTrack::Get(samplePtr buffer, sampleFormat format,
                     sampleCount start, size_t len, fillFormat fill,
                     bool mayThrow, sampleCount * pNumCopied) const
@@ -1999,7 +2184,9 @@ bool WaveTrack::Get(samplePtr buffer, sampleFormat format,
    bool doClear = true;
    bool result = true;
    sampleCount samplesCopied = 0;
-   for (const auto &clip: mClips)
+   const auto index = GetClipTimeIndex();
+   const auto clips = index->Near(start, start + len);
+   for (const auto clip: clips)
    {
       if (start >= clip->GetStartSample() && start+len <= clip->GetEndSample())
       {
@@ -2026,7 +2213,7 @@ bool WaveTrack::Get(samplePtr buffer, sampleFormat format,
       }
    }
 
-   for (const auto &clip: mClips)
+   for (const auto clip: clips)
    {
       auto clipStart = clip->GetStartSample();
       auto clipEnd = clip->GetEndSample();
@@ -2074,7 +2261,8 @@ void WaveTrack::Set(samplePtr buffer, sampleFormat format,
                     sampleCount start, size_t len)
 // WEAK-GUARANTEE
 {
-   for (const auto &clip: mClips)
+   const auto index = GetClipTimeIndex();
+   for (const auto clip: index->Near(start, start + len))
    {
       auto clipStart = clip->GetStartSample();
       auto clipEnd = clip->GetEndSample();
@@ -2119,22 +2307,24 @@ void WaveTrack::GetEnvelopeValues(double *buffer, size_t bufferLen,
    // The output buffer corresponds to an unbroken span of time which the callers expect
    // to be fully valid.  As clips are processed below, the output buffer is updated with
    // envelope values from any portion of a clip, start, end, middle, or none at all.
-   // Since this does not guarantee that the entire buffer is filled with values we need
-   // to initialize the entire buffer to a default value.
+   // The parts no clip covers get a default value.
    //
-   // This does mean that, in the cases where a usable clip is located, the buffer value will
-   // be set twice.  Unfortunately, there is no easy way around this since the clips are not
-   // stored in increasing time order.  If they were, we could just track the time as the
-   // buffer is filled.
-   for (decltype(bufferLen) i = 0; i < bufferLen; i++)
-   {
-      buffer[i] = 1.0;
-   }
+   // The clip index visits clips in increasing time order, so we track how far the
+   // buffer is filled and set only the gaps.  If clips overlap, the order is no help,
+   // so initialize the entire buffer first as before.
+   const auto index = GetClipTimeIndex();
+   size_t filled = 0;
+   const auto fillTo = [&](size_t end) {
+      for (; filled < end; ++filled)
+         buffer[filled] = 1.0;
+   };
+   if (index->unordered)
+      fillTo(bufferLen);
 
    double startTime = t0;
    auto tstep = 1.0 / mRate;
    double endTime = t0 + tstep * bufferLen;
-   for (const auto &clip: mClips)
+   for (const auto clip: index->Near(startTime, endTime, mRate))
    {
       // IF clip intersects startTime..endTime THEN...
       auto dClipStartTime = clip->GetStartTime();
@@ -2161,8 +2351,10 @@ void WaveTrack::GetEnvelopeValues(double *buffer, size_t bufferLen,
          {
             auto nClipLen = clip->GetEndSample() - clip->GetStartSample();
 
-            if (nClipLen <= 0) // Testing for bug 641, this problem is consistently '== 0', but doesn't hurt to check <.
+            if (nClipLen <= 0) { // Testing for bug 641, this problem is consistently '== 0', but doesn't hurt to check <.
+               fillTo(bufferLen);
                return;
+            }
 
             // This check prevents problem cited in http://bugzilla.audacityteam.org/show_bug.cgi?id=528#c11,
             // Gale's cross_fade_out project, which was already corrupted by bug 528.
@@ -2174,9 +2366,36 @@ void WaveTrack::GetEnvelopeValues(double *buffer, size_t bufferLen,
          }
          // Samples are obtained for the purpose of rendering a wave track,
          // so quantize time
+         fillTo(rbuf - buffer);
          clip->GetEnvelope()->GetValues(rbuf, rlen, rt0, tstep);
+         filled = std::max(filled, size_t(rbuf - buffer) + rlen);
+      }
+   }
+
+   fillTo(bufferLen);
+}
+
+bool WaveTrack::GetEnvelopeConstant(double t0, double t1, double &value) const
+{
+   value = 1.0;
+   bool found = false;
+
+   const auto index = GetClipTimeIndex();
+   for (const auto clip: index->Near(t0, t1, mRate))
+   {
+      if (clip->GetStartTime() < t1 && clip->GetEndTime() > t0)
+      {
+         double clipValue;
+         if (!clip->GetEnvelope()->IsConstant(clipValue))
+            return false;
+         if (found && clipValue != value)
+            return false;
+         value = clipValue;
+         found = true;
       }
    }
+
+   return true;
 }
 
 WaveClip* WaveTrack::GetClipAtX(int xcoord)
@@ -2194,13 +2413,14 @@ WaveClip* WaveTrack::GetClipAtX(int xcoord)
 
 WaveClip* WaveTrack::GetClipAtSample(sampleCount sample)
 {
-   for (const auto &clip: mClips)
+   const auto index = GetClipTimeIndex();
+   for (const auto clip: index->Near(sample, sample))
    {
       auto start = clip->GetStartSample();
       auto len   = clip->GetNumSamples();
 
       if (sample >= start && sample < start + len)
-         return clip.get();
+         return clip;
    }
 
    return NULL;
@@ -2210,23 +2430,31 @@ WaveClip* WaveTrack::GetClipAtSample(sampleCount sample)
 // latter clip is returned.
 WaveClip* WaveTrack::GetClipAtTime(double time)
 {
-   
-   const auto clips = SortedClipArray();
-   auto p = std::find_if(clips.rbegin(), clips.rend(), [&] (WaveClip* const& clip) {
+   using Reverse = WaveClipPointers::const_reverse_iterator;
+
+   const auto index = GetClipTimeIndex();
+   const auto &clips = index->clips;
+   const auto near = index->Near(time, time, mRate);
+   const Reverse rend{ near.begin() };
+   auto p = std::find_if(Reverse{ near.end() }, rend, [&] (WaveClip* const& clip) {
       return time >= clip->GetStartTime() && time <= clip->GetEndTime(); });
 
+   if (p == rend)
+      return nullptr;
+
    // When two clips are immediately next to each other, the GetEndTime() of the first clip
    // and the GetStartTime() of the second clip may not be exactly equal due to rounding errors.
    // If "time" is the end time of the first of two such clips, and the end time is slightly
    // less than the start time of the second clip, then the first rather than the
    // second clip is found by the above code. So correct this.
-   if (p != clips.rend() && p != clips.rbegin() &&
+   const auto next = p.base();
+   if (next != clips.end() &&
       time == (*p)->GetEndTime() &&
-      (*p)->SharesBoundaryWithNextClip(*(p-1))) {
-      p--;
+      (*p)->SharesBoundaryWithNextClip(*next)) {
+      return *next;
    }
 
-   return p != clips.rend() ? *p : nullptr;
+   return *p;
 }
 
 Envelope* WaveTrack::GetEnvelopeAtX(int xcoord)
@@ -2249,8 +2477,7 @@ Sequence* WaveTrack::GetSequenceAtX(int xcoord)
 
 WaveClip* WaveTrack::CreateClip()
 {
-   mClips.push_back(std::make_unique<WaveClip>(mDirManager, mFormat, mRate, GetWaveColorIndex()));
-   return mClips.back().get();
+   return InsertClip(std::make_unique<WaveClip>(mDirManager, mFormat, mRate, GetWaveColorIndex()));
 }
 
 WaveClip* WaveTrack::NewestOrNewClip()
@@ -2418,7 +2645,7 @@ void WaveTrack::SplitAt(double t)
          newClip->Offset(here.as_double()/(double)mRate);
          // This could invalidate the iterators for the loop!  But we return
          // at once so it's okay
-         mClips.push_back(std::move(newClip)); // transfer ownership
+         InsertClip(std::move(newClip)); // transfer ownership
          return;
       }
    }
@@ -2567,7 +2794,7 @@ void WaveTrack::MergeClips(int clipidx1, int clipidx2)
    // use NOFAIL-GUARANTEE for the rest
    // Delete second clip
    auto it = FindClip(mClips, clip2);
-   mClips.erase(it);
+   EraseClip(it);
 }
 
 void WaveTrack::Resample(int rate, ProgressDialog *progress)
@@ -2580,28 +2807,15 @@ void WaveTrack::Resample(int rate, ProgressDialog *progress)
    mRate = rate;
 }
 
-namespace {
-   template < typename Cont1, typename Cont2 >
-   Cont1 FillSortedClipArray(const Cont2& mClips)
-   {
-      Cont1 clips;
-      for (const auto &clip : mClips)
-         clips.push_back(clip.get());
-      std::sort(clips.begin(), clips.end(),
-         [](const WaveClip *a, const WaveClip *b)
-      { return a->GetStartTime() < b->GetStartTime(); });
-      return clips;
-   }
-}
-
 WaveClipPointers WaveTrack::SortedClipArray()
 {
-   return FillSortedClipArray<WaveClipPointers>(mClips);
+   return GetClipTimeIndex()->clips;
 }
 
 WaveClipConstPointers WaveTrack::SortedClipArray() const
 {
-   return FillSortedClipArray<WaveClipConstPointers>(mClips);
+   const auto &clips = GetClipTimeIndex()->clips;
+   return { clips.begin(), clips.end() };
 }
 
 ///Deletes all clips' wavecaches.  Careful, This may not be threadsafe.
@@ -13,6 +13,7 @@
 
 #include "Track.h"
 #include "SampleFormat.h"
+#include "Sequence.h"
 #include "WaveClip.h"
 #include "Experimental.h"
 #include "widgets/ProgressDialog.h"
@@ -266,12 +267,25 @@ private:
    void GetEnvelopeValues(double *buffer, size_t bufferLen,
                          double t0) const;
 
+   // Return true, and the value, if the envelopes of all clips meeting the
+   // span from t0 to t1 are flat with one value.  Samples between clips are
+   // silent, so the gain there does not matter.
+   bool GetEnvelopeConstant(double t0, double t1, double &value) const;
+
    // May assume precondition: t0 <= t1
    std::pair<float, float> GetMinMax(
       double t0, double t1, bool mayThrow = true) const;
    // May assume precondition: t0 <= t1
    float GetRMS(double t0, double t1, bool mayThrow = true) const;
 
+   // Visits the samples from start through start + len - 1 in order, as
+   // Sequence::ScanWithSummaries does for each clip.  Space between clips
+   // is visited as zeroes.
+   bool ScanWithSummaries(sampleCount start, sampleCount len,
+      const Sequence::SummaryPredicate &ruledIn,
+      const Sequence::SummaryVisitor &visit,
+      bool mayThrow = true) const;
+
    //
    // MM: We now have more than one sequence and envelope per track, so
    // instead of GetSequence() and GetEnvelope() we have the following
@@ -660,6 +674,22 @@ private:
    std::weak_ptr<SampleHandle> mSampleHandle;
    std::weak_ptr<EnvelopeHandle> mEnvelopeHandle;
 
+   // Clips enter and leave mClips only through these, so that each clip
+   // reports changes of its offset, length or rate to this track's counter
+   WaveClip *InsertClip(WaveClipHolder clip);
+   WaveClipHolder EraseClip(WaveClipHolders::iterator it);
+   std::shared_ptr<WaveClip::LayoutGeneration> mLayoutGeneration{
+      std::make_shared<WaveClip::LayoutGeneration>(0) };
+
+   // The clips sorted by start time, so that lookups by time or sample can
+   // search instead of visiting every clip.  It is rebuilt on demand when
+   // mLayoutGeneration has moved on since it was made.  The audio thread
+   // holds its own reference while it reads, so a rebuild on the main thread
+   // does not pull the index out from under it.
+   struct ClipIndex;
+   std::shared_ptr<const ClipIndex> GetClipTimeIndex() const;
+   mutable std::shared_ptr<const ClipIndex> mClipIndex;
+
 protected:
    std::shared_ptr<TrackControls> GetControls() override;
    std::shared_ptr<TrackVRulerControls> GetVRulerControls() override;
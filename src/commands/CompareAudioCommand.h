@@ -49,9 +49,6 @@ private:
    // Update member variables with project selection data (and validate)
    bool GetSelection(const CommandContext &context, AudacityProject &proj);
 
-protected:
-   double CompareSample(double value1, double value2) /* not override */;
-
 };
 
 #endif /* End of include guard: __COMPAREAUDIOCOMMAND__ */
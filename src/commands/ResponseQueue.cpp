@@ -35,7 +35,8 @@ void ResponseQueue::AddResponse(Response response)
 Response ResponseQueue::WaitAndGetResponse()
 {
    wxMutexLocker locker(mMutex);
-   if (mResponses.empty())
+   // Wait() may return without a signal, so check again each time
+   while (mResponses.empty())
    {
       mCondition.Wait();
    }
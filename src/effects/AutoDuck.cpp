@@ -21,6 +21,7 @@
 
 #include <math.h>
 #include <float.h>
+#include <algorithm>
 
 #include <wx/dcclient.h>
 #include <wx/dcmemory.h>
@@ -56,7 +57,7 @@ static const size_t kBufSize = 131072u;     // number of samples to process at o
 static const size_t kRMSWindowSize = 100u;  // samples in circular RMS window buffer
 
 /*
- * A auto duck region and an array of auto duck regions
+ * A auto duck region
  */
 
 struct AutoDuckRegion
@@ -286,129 +287,173 @@ bool EffectAutoDuck::Process()
    auto minSamplesPause =
       mControlTrack->TimeToLongSamples(maxPause);
 
+   const float peakThreshold = DB_TO_LINEAR(mThresholdDb);
    double threshold = DB_TO_LINEAR(mThresholdDb);
 
    // adjust the threshold so we can compare it to the rmsSum value
    threshold = threshold * threshold * kRMSWindowSize;
 
-   int rmsPos = 0;
-   float rmsSum = 0;
-   // to make the progress bar appear more natural, we first look for all
-   // duck regions and apply them all at once afterwards
-   std::vector<AutoDuckRegion> regions;
-   bool inDuckRegion = false;
-   {
-      Floats rmsWindow{ kRMSWindowSize, true };
+   CopyInputTracks(); // Set up mOutputTracks.
 
-      Floats buf{ kBufSize };
+   // Each duck region is applied as soon as it is found, so that the
+   // progress bar moves through the selection just once
+   std::vector<WaveTrack*> outputTracks;
+   for( auto iterTrack : mOutputTracks->Selected< WaveTrack >() )
+      outputTracks.push_back(iterTrack);
 
-      // initialize the following two variables to prevent compiler warning
-      double duckRegionStart = 0;
-      sampleCount curSamplesPause = 0;
+   Floats buf{ kBufSize };
 
-      auto pos = start;
+   auto applyRegion = [&](const AutoDuckRegion &region) {
+      int trackNum = 0;
+      for (auto track : outputTracks)
+         if (ApplyDuckFade(trackNum++, track, region.t0, region.t1, buf.get()))
+            return false;
+      return true;
+   };
 
-      while (pos < end)
-      {
-         const auto len = limitSampleBufferSize( kBufSize, end - pos );
-         
-         mControlTrack->Get((samplePtr)buf.get(), floatSample, pos, len);
+   int rmsPos = 0;
+   float rmsSum = 0;
+   bool inDuckRegion = false;
+   Floats rmsWindow{ kRMSWindowSize, true };
 
-         for (auto i = pos; i < pos + len; i++)
-         {
-            rmsSum -= rmsWindow[rmsPos];
-            // i - pos is bounded by len:
-            auto index = ( i - pos ).as_size_t();
-            rmsWindow[rmsPos] = buf[ index ] * buf[ index ];
-            rmsSum += rmsWindow[rmsPos];
-            rmsPos = (rmsPos + 1) % kRMSWindowSize;
-
-            bool thresholdExceeded = rmsSum > threshold;
-
-            if (thresholdExceeded)
-            {
-               // everytime the threshold is exceeded, reset our count for
-               // the number of pause samples
-               curSamplesPause = 0;
-
-               if (!inDuckRegion)
-               {
-                  // the threshold has been exceeded for the first time, so
-                  // let the duck region begin here
-                  inDuckRegion = true;
-                  duckRegionStart = mControlTrack->LongSamplesToTime(i);
-               }
-            }
+   // initialize the following two variables to prevent compiler warning
+   double duckRegionStart = 0;
+   sampleCount curSamplesPause = 0;
 
-            if (!thresholdExceeded && inDuckRegion)
-            {
-               // the threshold has not been exceeded and we are in a duck
-               // region, but only fade in if the maximum pause has been
-               // exceeded
-               curSamplesPause += 1;
+   auto endRegion = [&](sampleCount i) {
+      // do the actual duck fade and reset all values
+      double duckRegionEnd =
+         mControlTrack->LongSamplesToTime(i - curSamplesPause);
 
-               if (curSamplesPause >= minSamplesPause)
-               {
-                  // do the actual duck fade and reset all values
-                  double duckRegionEnd =
-                     mControlTrack->LongSamplesToTime(i - curSamplesPause);
+      inDuckRegion = false;
 
-                  regions.push_back(AutoDuckRegion(
-                     duckRegionStart - mOuterFadeDownLen,
-                     duckRegionEnd + mOuterFadeUpLen));
+      return applyRegion(AutoDuckRegion(
+         duckRegionStart - mOuterFadeDownLen,
+         duckRegionEnd + mOuterFadeUpLen));
+   };
 
-                  inDuckRegion = false;
-               }
-            }
-         }
+   auto step = [&](sampleCount i, float sample) {
+      rmsSum -= rmsWindow[rmsPos];
+      rmsWindow[rmsPos] = sample * sample;
+      rmsSum += rmsWindow[rmsPos];
+      rmsPos = (rmsPos + 1) % kRMSWindowSize;
+
+      bool thresholdExceeded = rmsSum > threshold;
 
-         pos += len;
+      if (thresholdExceeded)
+      {
+         // everytime the threshold is exceeded, reset our count for
+         // the number of pause samples
+         curSamplesPause = 0;
 
-         if (TotalProgress(
-            (pos - start).as_double() /
-            (end - start).as_double() /
-            (GetNumWaveTracks() + 1)
-         ))
+         if (!inDuckRegion)
          {
-            cancel = true;
-            break;
+            // the threshold has been exceeded for the first time, so
+            // let the duck region begin here
+            inDuckRegion = true;
+            duckRegionStart = mControlTrack->LongSamplesToTime(i);
          }
       }
 
-      // apply last duck fade, if any
-      if (inDuckRegion)
+      if (!thresholdExceeded && inDuckRegion)
       {
-         double duckRegionEnd =
-            mControlTrack->LongSamplesToTime(end - curSamplesPause);
-         regions.push_back(AutoDuckRegion(
-            duckRegionStart - mOuterFadeDownLen,
-            duckRegionEnd + mOuterFadeUpLen));
+         // the threshold has not been exceeded and we are in a duck
+         // region, but only fade in if the maximum pause has been
+         // exceeded
+         curSamplesPause += 1;
+
+         if (curSamplesPause >= minSamplesPause)
+            return endRegion(i);
       }
-   }
 
-   if (!cancel)
-   {
-      CopyInputTracks(); // Set up mOutputTracks.
+      return true;
+   };
+
+   // Does for count samples, none of them exceeding the threshold, what
+   // step() would do
+   auto pause = [&](sampleCount first, sampleCount count) {
+      if (!inDuckRegion || count <= 0)
+         return true;
+
+      // the sample at which the maximum pause is exceeded
+      sampleCount needed = minSamplesPause - curSamplesPause;
+      if (needed < 1)
+         needed = 1;
+      if (needed > count) {
+         curSamplesPause += count;
+         return true;
+      }
 
-      int trackNum = 0;
+      curSamplesPause += needed;
+      return endRegion(first + needed - 1);
+   };
 
-      for( auto iterTrack : mOutputTracks->Selected< WaveTrack >() )
-      {
-         for (size_t i = 0; i < regions.size(); i++)
-         {
-            const AutoDuckRegion& region = regions[i];
-            if (ApplyDuckFade(trackNum, iterTrack, region.t0, region.t1))
-            {
+   Floats quiet{ 2 * kRMSWindowSize };
+   double progress = 0;
+   auto stepQuiet = [&](sampleCount first, size_t count) {
+      mControlTrack->Get((samplePtr)quiet.get(), floatSample, first, count);
+      for (size_t i = 0; i < count; ++i)
+         if (!step(first + i, quiet[i]))
+            return false;
+      return true;
+   };
+
+   // The block summaries show most quiet stretches of the control track
+   // without reading them.  No sample of such a stretch exceeds the
+   // threshold, so neither does any RMS window lying wholly within it.
+   mControlTrack->ScanWithSummaries(start, end - start,
+      [=](float min, float max) {
+         return max < peakThreshold && -min < peakThreshold;
+      },
+      [&](sampleCount runStart, sampleCount runLen, const float *samples) {
+         if (samples) {
+            for (size_t i = 0, n = runLen.as_size_t(); i < n; ++i)
+               if (!step(runStart + i, samples[i])) {
+                  cancel = true;
+                  return false;
+               }
+         }
+         else if (runLen < 2 * kRMSWindowSize) {
+            if (!stepQuiet(runStart, runLen.as_size_t())) {
                cancel = true;
-               break;
+               return false;
+            }
+         }
+         else {
+            // Windows reaching back before the run need its first samples,
+            // and the window must hold its last samples after it.
+            // Between them, only the count of pause samples changes.
+            const auto head = kRMSWindowSize - 1;
+            const auto tail = kRMSWindowSize;
+            if (!stepQuiet(runStart, head) ||
+                !pause(runStart + head, runLen - head - tail) ||
+                !stepQuiet(runStart + runLen - tail, tail)) {
+               cancel = true;
+               return false;
             }
          }
 
-         if (cancel)
-            break;
+         // Applying a region moves the progress bar on from where the
+         // region began, so hold it there until then
+         if (!inDuckRegion)
+            progress = (runStart + runLen - start).as_double() /
+               (end - start).as_double();
+         if (TotalProgress(progress)) {
+            cancel = true;
+            return false;
+         }
+         return true;
+      });
 
-         trackNum++;
-      }
+   // apply last duck fade, if any
+   if (!cancel && inDuckRegion)
+   {
+      double duckRegionEnd =
+         mControlTrack->LongSamplesToTime(end - curSamplesPause);
+      if (!applyRegion(AutoDuckRegion(
+         duckRegionStart - mOuterFadeDownLen,
+         duckRegionEnd + mOuterFadeUpLen)))
+         cancel = true;
    }
 
    ReplaceProcessedTracks(!cancel);
@@ -507,16 +552,35 @@ bool EffectAutoDuck::TransferDataFromWindow()
 
 // EffectAutoDuck implementation
 
+// Multiplies the samples by gain, gain * ratio, gain * ratio^2, ...
+static void ApplyGainRamp(float *buffer, size_t len, double gain, double ratio)
+{
+   // Four interleaved sequences of gains, each advancing by ratio^4, leave
+   // the multiplications independent of one another, so they vectorize
+   const double ratio2 = ratio * ratio;
+   const double ratio4 = ratio2 * ratio2;
+   double gains[4] = { gain, gain * ratio, gain * ratio2, gain * ratio2 * ratio };
+
+   size_t i = 0;
+   for (; i + 4 <= len; i += 4)
+      for (size_t j = 0; j < 4; ++j) {
+         buffer[i + j] *= gains[j];
+         gains[j] *= ratio4;
+      }
+
+   for (size_t j = 0; i < len; ++i, ++j)
+      buffer[i] *= gains[j];
+}
+
 // this currently does an exponential fade
 bool EffectAutoDuck::ApplyDuckFade(int trackNum, WaveTrack* t,
-                                   double t0, double t1)
+                                   double t0, double t1, float *buf)
 {
    bool cancel = false;
 
    auto start = t->TimeToLongSamples(t0);
    auto end = t->TimeToLongSamples(t1);
 
-   Floats buf{ kBufSize };
    auto pos = start;
 
    auto fadeDownSamples = t->TimeToLongSamples(
@@ -532,37 +596,71 @@ bool EffectAutoDuck::ApplyDuckFade(int trackNum, WaveTrack* t,
    float fadeDownStep = mDuckAmountDb / fadeDownSamples.as_double();
    float fadeUpStep = mDuckAmountDb / fadeUpSamples.as_double();
 
+   // The gain in dB is linear in each of three segments: the fade down,
+   // the full duck, and the fade up.  If the fades meet before reaching the
+   // duck amount, the middle segment is empty.
+   auto fadesDown = [&](sampleCount i) {
+      return fadeDownStep * (i - start).as_float() >
+         fadeUpStep * (end - i).as_float();
+   };
+   // the first sample where the fade up is the greater
+   auto meet = start + sampleCount(
+      (end - start).as_double() * fadeDownSamples.as_double() /
+      (fadeDownSamples + fadeUpSamples).as_double());
+   while (meet < end && fadesDown(meet))
+      ++meet;
+   while (meet > start && !fadesDown(meet - 1))
+      --meet;
+   const auto fadeDownEnd = std::min(start + fadeDownSamples, meet);
+   const auto fadeUpStart = std::max(end - fadeUpSamples, meet);
+   const double duckGain = DB_TO_LINEAR(mDuckAmountDb);
+
+   // processing of tracks for a region spans its share of the progress bar
+   const double progressStart = (t0 - mT0) / (mT1 - mT0);
+   const double progressSpan = (t1 - t0) / (mT1 - mT0);
+
    while (pos < end)
    {
       const auto len = limitSampleBufferSize( kBufSize, end - pos );
 
-      t->Get((samplePtr)buf.get(), floatSample, pos, len);
+      t->Get((samplePtr)buf, floatSample, pos, len);
 
-      for (auto i = pos; i < pos + len; i++)
+      for (auto i = pos; i < pos + len;)
       {
-         float gainDown = fadeDownStep * (i - start).as_float();
-         float gainUp = fadeUpStep * (end - i).as_float();
-
-         float gain;
-         if (gainDown > gainUp)
-            gain = gainDown;
-         else
-            gain = gainUp;
-         if (gain < mDuckAmountDb)
-            gain = mDuckAmountDb;
-
          // i - pos is bounded by len:
-         buf[ ( i - pos ).as_size_t() ] *= DB_TO_LINEAR(gain);
+         auto segmentBuf = buf + ( i - pos ).as_size_t();
+         if (i < fadeDownEnd) {
+            const auto n =
+               limitSampleBufferSize( len, std::min(fadeDownEnd, pos + len) - i );
+            ApplyGainRamp(segmentBuf, n,
+               DB_TO_LINEAR(fadeDownStep * (i - start).as_double()),
+               DB_TO_LINEAR(fadeDownStep));
+            i += n;
+         }
+         else if (i < fadeUpStart) {
+            const auto n =
+               limitSampleBufferSize( len, std::min(fadeUpStart, pos + len) - i );
+            for (size_t j = 0; j < n; ++j)
+               segmentBuf[j] *= duckGain;
+            i += n;
+         }
+         else {
+            const auto n = limitSampleBufferSize( len, pos + len - i );
+            ApplyGainRamp(segmentBuf, n,
+               DB_TO_LINEAR(fadeUpStep * (end - i).as_double()),
+               DB_TO_LINEAR(-fadeUpStep));
+            i += n;
+         }
       }
 
-      t->Set((samplePtr)buf.get(), floatSample, pos, len);
+      t->Set((samplePtr)buf, floatSample, pos, len);
 
       pos += len;
 
-      float curTime = t->LongSamplesToTime(pos);
-      float fractionFinished = (curTime - mT0) / (mT1 - mT0);
-      if (TotalProgress( (trackNum + 1 + fractionFinished) /
-                         (GetNumWaveTracks() + 1) ))
+      double fractionFinished =
+         (pos - start).as_double() / (end - start).as_double();
+      if (TotalProgress( progressStart + progressSpan *
+                         (trackNum + fractionFinished) / GetNumWaveTracks() ))
       {
          cancel = true;
          break;
@@ -63,7 +63,8 @@ public:
 private:
    // EffectAutoDuck implementation
 
-   bool ApplyDuckFade(int trackNum, WaveTrack *t, double t0, double t1);
+   bool ApplyDuckFade(int trackNum, WaveTrack *t, double t0, double t1,
+                      float *buf);
 
    void OnValueChanged(wxCommandEvent & evt);
 
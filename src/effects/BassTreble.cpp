@@ -324,15 +324,8 @@ void EffectBassTreble::InstanceInit(EffectBassTrebleState & data, float sampleRa
    data.b1Treble = 0;
    data.b2Treble = 0;
 
-   data.xn1Bass = 0;
-   data.xn2Bass = 0;
-   data.yn1Bass = 0;
-   data.yn2Bass = 0;
-
-   data.xn1Treble = 0;
-   data.xn2Treble = 0;
-   data.yn1Treble = 0;
-   data.yn2Treble = 0;
+   Biquad sections[2];
+   data.filter.SetSections(sections, 2);
 
    data.bass = -1;
    data.treble = -1;
@@ -344,6 +337,22 @@ void EffectBassTreble::InstanceInit(EffectBassTrebleState & data, float sampleRa
 // EffectClientInterface implementation
 
 
+namespace {
+
+Biquad Section(double a0, double a1, double a2,
+               double b0, double b1, double b2, double gain)
+{
+   Biquad section;
+   section.fNumerCoeffs[Biquad::B0] = b0 * gain / a0;
+   section.fNumerCoeffs[Biquad::B1] = b1 * gain / a0;
+   section.fNumerCoeffs[Biquad::B2] = b2 * gain / a0;
+   section.fDenomCoeffs[Biquad::A1] = a1 / a0;
+   section.fDenomCoeffs[Biquad::A2] = a2 / a0;
+   return section;
+}
+
+}
+
 size_t EffectBassTreble::InstanceProcess(EffectBassTrebleState & data,
                                               float **inBlock,
                                               float **outBlock,
@@ -370,9 +379,13 @@ size_t EffectBassTreble::InstanceProcess(EffectBassTrebleState & data,
                   data.a0Treble, data.a1Treble, data.a2Treble,
                   data.b0Treble, data.b1Treble, data.b2Treble);
 
-   for (decltype(blockLen) i = 0; i < blockLen; i++) {
-      obuf[i] = DoFilter(data, ibuf[i]) * data.gain;
-   }
+   // The output gain is applied by the treble shelf
+   data.filter.SetSection(0, Section(data.a0Bass, data.a1Bass, data.a2Bass,
+      data.b0Bass, data.b1Bass, data.b2Bass, 1.0));
+   data.filter.SetSection(1, Section(data.a0Treble, data.a1Treble,
+      data.a2Treble, data.b0Treble, data.b1Treble, data.b2Treble, data.gain));
+
+   data.filter.Process(&ibuf, &obuf, blockLen);
 
    return blockLen;
 }
@@ -410,29 +423,6 @@ void EffectBassTreble::Coefficents(double hz, double slope, double gain, double
    }
 }
 
-float EffectBassTreble::DoFilter(EffectBassTrebleState & data, float in)
-{
-   // Bass filter
-   float out = (data.b0Bass * in + data.b1Bass * data.xn1Bass + data.b2Bass * data.xn2Bass -
-         data.a1Bass * data.yn1Bass - data.a2Bass * data.yn2Bass) / data.a0Bass;
-   data.xn2Bass = data.xn1Bass;
-   data.xn1Bass = in;
-   data.yn2Bass = data.yn1Bass;
-   data.yn1Bass = out;
-
-   // Treble filter
-   in = out;
-   out = (data.b0Treble * in + data.b1Treble * data.xn1Treble + data.b2Treble * data.xn2Treble -
-         data.a1Treble * data.yn1Treble - data.a2Treble * data.yn2Treble) / data.a0Treble;
-   data.xn2Treble = data.xn1Treble;
-   data.xn1Treble = in;
-   data.yn2Treble = data.yn1Treble;
-   data.yn1Treble = out;
-
-   return out;
-}
-
-
 void EffectBassTreble::OnBassText(wxCommandEvent & WXUNUSED(evt))
 {
    double oldBass = mBass;
@@ -11,6 +11,8 @@ Max Maisel
 
 #include "Biquad.h"
 
+#include <algorithm>
+
 #define square(a) ((a)*(a))
 
 Biquad::Biquad()
@@ -39,6 +41,129 @@ void Biquad::Process(int iNumSamples)
       *pfOut++ = ProcessOne(*pfIn++);
 }
 
+BiquadCascade::BiquadCascade()
+   : mChannels{ 1 }
+{
+}
+
+void BiquadCascade::SetSections(const Biquad *sections, size_t nSections)
+{
+   mSections.resize(nSections);
+   for (size_t iSection = 0; iSection < nSections; ++iSection)
+      SetSection(iSection, sections[iSection]);
+   Reset();
+}
+
+void BiquadCascade::SetSection(size_t iSection, const Biquad &section)
+{
+   mSections[iSection] = {
+      section.fNumerCoeffs[Biquad::B0],
+      section.fNumerCoeffs[Biquad::B1],
+      section.fNumerCoeffs[Biquad::B2],
+      section.fDenomCoeffs[Biquad::A1],
+      section.fDenomCoeffs[Biquad::A2],
+   };
+}
+
+void BiquadCascade::SetChannels(unsigned nChannels)
+{
+   mChannels = nChannels;
+   Reset();
+}
+
+void BiquadCascade::Reset()
+{
+   const auto nGroups = (mChannels + kLanes - 1) / kLanes;
+   mState.assign(nGroups * mSections.size() * 2 * kLanes, 0.0f);
+}
+
+void BiquadCascade::Process(
+   const float *const *in, float *const *out, size_t len)
+{
+   if (mChannels == 1) {
+      ProcessChannel(in[0], out[0], len);
+      return;
+   }
+
+   for (unsigned iChannel = 0, iGroup = 0; iChannel < mChannels;
+        iChannel += kLanes, ++iGroup)
+      ProcessGroup(iGroup, in + iChannel, out + iChannel, len);
+}
+
+void BiquadCascade::ProcessChannel(const float *in, float *out, size_t len)
+{
+   if (mSections.empty()) {
+      if (out != in)
+         std::copy(in, in + len, out);
+      return;
+   }
+
+   // Each section takes the whole block, keeping its state in registers
+   auto state = mState.data();
+   for (const auto &section : mSections) {
+      const auto b0 = section.b0, b1 = section.b1, b2 = section.b2,
+         a1 = section.a1, a2 = section.a2;
+      auto s1 = state[0], s2 = state[kLanes];
+      for (size_t i = 0; i < len; ++i) {
+         const auto x = in[i];
+         const auto y = b0 * x + s1;
+         s1 = b1 * x - a1 * y + s2;
+         s2 = b2 * x - a2 * y;
+         out[i] = y;
+      }
+      state[0] = s1, state[kLanes] = s2;
+      state += 2 * kLanes;
+      in = out;
+   }
+}
+
+void BiquadCascade::ProcessGroup(unsigned iGroup,
+   const float *const *in, float *const *out, size_t len)
+{
+   const auto nLanes = std::min<unsigned>(kLanes, mChannels - iGroup * kLanes);
+
+   // Samples of the group's channels, interleaved so that each step of the
+   // filters below is one operation on all the lanes
+   float x[kChunk][kLanes];
+
+   for (size_t done = 0; done < len; done += kChunk) {
+      const auto chunk = std::min<size_t>(kChunk, len - done);
+
+      for (size_t i = 0; i < chunk; ++i) {
+         for (unsigned lane = 0; lane < nLanes; ++lane)
+            x[i][lane] = in[lane][done + i];
+         for (unsigned lane = nLanes; lane < kLanes; ++lane)
+            x[i][lane] = 0;
+      }
+
+      auto state =
+         mState.data() + iGroup * mSections.size() * 2 * kLanes;
+      for (const auto &section : mSections) {
+         const auto b0 = section.b0, b1 = section.b1, b2 = section.b2,
+            a1 = section.a1, a2 = section.a2;
+         float s1[kLanes], s2[kLanes];
+         std::copy(state, state + kLanes, s1);
+         std::copy(state + kLanes, state + 2 * kLanes, s2);
+         for (size_t i = 0; i < chunk; ++i) {
+            auto xi = x[i];
+            for (unsigned lane = 0; lane < kLanes; ++lane) {
+               const auto y = b0 * xi[lane] + s1[lane];
+               s1[lane] = b1 * xi[lane] - a1 * y + s2[lane];
+               s2[lane] = b2 * xi[lane] - a2 * y;
+               xi[lane] = y;
+            }
+         }
+         std::copy(s1, s1 + kLanes, state);
+         std::copy(s2, s2 + kLanes, state + kLanes);
+         state += 2 * kLanes;
+      }
+
+      for (size_t i = 0; i < chunk; ++i)
+         for (unsigned lane = 0; lane < nLanes; ++lane)
+            out[lane][done + i] = x[i][lane];
+   }
+}
+
 void ComplexDiv (float fNumerR, float fNumerI, float fDenomR, float fDenomI, float* pfQuotientR, float* pfQuotientI)
 {
    float fDenom = square(fDenomR) + square(fDenomI);
@@ -12,6 +12,8 @@ Max Maisel
 #ifndef __BIQUAD_H__
 #define __BIQUAD_H__
 
+#include <cstddef>
+#include <vector>
 
 /// \brief Represents a biquad digital filter.
 struct Biquad
@@ -52,6 +54,54 @@ struct Biquad
    float fPrevPrevOut;
 };
 
+/// \brief A chain of biquad sections, each in transposed direct form II,
+/// applied to one or more channels a block at a time.
+///
+/// A single channel is run through one section after another over the whole
+/// block.  Several channels are run together in groups of kLanes, in loops
+/// over the lanes of a group which compilers can vectorize.
+class BiquadCascade
+{
+public:
+   enum { kLanes = 4 };
+
+   BiquadCascade();
+
+   /// Copy the coefficients of nSections sections, in order of application,
+   /// and clear all state
+   void SetSections(const Biquad *sections, size_t nSections);
+   /// Change the coefficients of one section, keeping the state of all
+   void SetSection(size_t iSection, const Biquad &section);
+   size_t GetSections() const { return mSections.size(); }
+
+   /// Set the number of channels and clear all state
+   void SetChannels(unsigned nChannels);
+   unsigned GetChannels() const { return mChannels; }
+
+   void Reset();
+
+   /// Filter len samples of each channel.  out[i] may be the same as in[i].
+   void Process(const float *const *in, float *const *out, size_t len);
+
+private:
+   enum { kChunk = 256 };
+
+   struct Coefficients
+   {
+      float b0, b1, b2, a1, a2;
+   };
+
+   void ProcessChannel(const float *in, float *out, size_t len);
+   void ProcessGroup(unsigned iGroup, const float *const *in,
+      float *const *out, size_t len);
+
+   std::vector<Coefficients> mSections;
+   unsigned mChannels;
+   // For each group of kLanes channels, then each section, the first and
+   // then the second state variable of each lane
+   std::vector<float> mState;
+};
+
 void ComplexDiv (float fNumerR, float fNumerI, float fDenomR, float fDenomI, float* pfQuotientR, float* pfQuotientI);
 bool BilinTransform (float fSX, float fSY, float* pfZX, float* pfZY);
 float Calc2D_DistSqr (float fX1, float fY1, float fX2, float fY2);
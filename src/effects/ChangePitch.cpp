@@ -219,9 +219,11 @@ bool EffectChangePitch::Process()
       // ensure that m_dSemitonesChange is set.
       Calc_SemitonesChange_fromPercentChange();
 
-      mSoundTouch = std::make_unique<soundtouch::SoundTouch>();
+      auto initer = [&](soundtouch::SoundTouch *soundtouch)
+      {
+         soundtouch->setPitchSemiTones((float)(m_dSemitonesChange));
+      };
       IdentityTimeWarper warper;
-      mSoundTouch->setPitchSemiTones((float)(m_dSemitonesChange));
 #ifdef USE_MIDI
       // Pitch shifting note tracks is currently only supported by SoundTouchEffect
       // and non-real-time-preview effects require an audio track selection.
@@ -235,7 +237,7 @@ bool EffectChangePitch::Process()
       // eliminate the next line:
       mSemitones = m_dSemitonesChange;
 #endif
-      return EffectSoundTouch::ProcessWithTimeWarper(warper);
+      return EffectSoundTouch::ProcessWithTimeWarper(initer, warper);
    }
 }
 
@@ -203,12 +203,14 @@ bool EffectChangeTempo::Process()
    else
 #endif
    {
-      mSoundTouch = std::make_unique<soundtouch::SoundTouch>();
-      mSoundTouch->setTempoChange(m_PercentChange);
+      auto initer = [&](soundtouch::SoundTouch *soundtouch)
+      {
+         soundtouch->setTempoChange(m_PercentChange);
+      };
       double mT1Dashed = mT0 + (mT1 - mT0)/(m_PercentChange/100.0 + 1.0);
       RegionTimeWarper warper{ mT0, mT1,
          std::make_unique<LinearTimeWarper>(mT0, mT0, mT1, mT1Dashed )  };
-      success = EffectSoundTouch::ProcessWithTimeWarper(warper);
+      success = EffectSoundTouch::ProcessWithTimeWarper(initer, warper);
    }
 
    if(success)
@@ -27,11 +27,14 @@
 #include "../Audacity.h"
 #include "ClickRemoval.h"
 
+#include <algorithm>
+#include <vector>
 #include <math.h>
 
 #include <wx/intl.h>
 #include <wx/valgen.h>
 
+#include "../ParallelFor.h"
 #include "../Prefs.h"
 #include "../ShuttleGui.h"
 #include "../widgets/ErrorDialog.h"
@@ -217,35 +220,83 @@ bool EffectClickRemoval::ProcessOne(int count, WaveTrack * track, sampleCount st
    if (idealBlockLen % windowSize != 0)
       idealBlockLen += (windowSize - (idealBlockLen % windowSize));
 
-   bool bResult = true;
-   decltype(len) s = 0;
-   Floats buffer{ idealBlockLen };
-   Floats datawindow{ windowSize };
-   while ((len - s) > windowSize / 2)
-   {
-      auto block = limitSampleBufferSize( idealBlockLen, len - s );
-
-      track->Get((samplePtr) buffer.get(), floatSample, start + s, block);
-
-      for (decltype(block) i = 0; i + windowSize / 2 < block; i += windowSize / 2)
+   // Windows never span two blocks, so blocks are independent, and several
+   // are processed at once, one per thread of the pool.  Reading and writing
+   // of the track stay on this thread.
+   const size_t nThreads = ParallelForConcurrency();
+
+   struct Block {
+      sampleCount start;
+      size_t len;
+      int firstSep;
+      Floats buffer;
+      bool didSomething;
+   };
+   std::vector<Block> blocks(nThreads);
+   for (auto &block : blocks)
+      block.buffer.reinit(idealBlockLen);
+
+   // The first window ever given to RemoveClicks() uses sep as constructed;
+   // it is rounded up to a power of two for all later ones
+   int roundedSep = 1;
+   while (roundedSep < sep)
+      roundedSep *= 2;
+
+   auto processBlock = [this, roundedSep, &blocks](size_t ii) {
+      auto &block = blocks[ii];
+      Floats datawindow{ windowSize };
+      auto blockSep = block.firstSep;
+      const auto buffer = block.buffer.get();
+      for (size_t i = 0; i + windowSize / 2 < block.len;
+           i += windowSize / 2)
       {
-         auto wcopy = std::min( windowSize, block - i );
+         auto wcopy = std::min( windowSize, block.len - i );
 
          for(decltype(wcopy) j = 0; j < wcopy; j++)
             datawindow[j] = buffer[i+j];
          for(auto j = wcopy; j < windowSize; j++)
             datawindow[j] = 0;
 
-         mbDidSomething |= RemoveClicks(windowSize, datawindow.get());
+         block.didSomething |=
+            RemoveClicks(windowSize, datawindow.get(), blockSep);
+         blockSep = roundedSep;
 
          for(decltype(wcopy) j = 0; j < wcopy; j++)
            buffer[i+j] = datawindow[j];
       }
+   };
 
-      if (mbDidSomething) // RemoveClicks() actually did something.
-         track->Set((samplePtr) buffer.get(), floatSample, start + s, block);
+   bool bResult = true;
+   decltype(len) s = 0;
+   while ((len - s) > windowSize / 2)
+   {
+      size_t nBlocks = 0;
+      while (nBlocks < nThreads && (len - s) > windowSize / 2)
+      {
+         auto &block = blocks[nBlocks++];
+         block.start = start + s;
+         block.len = limitSampleBufferSize( idealBlockLen, len - s );
+         block.firstSep = roundedSep;
+         block.didSomething = false;
 
-      s += block;
+         track->Get((samplePtr) block.buffer.get(), floatSample,
+                    block.start, block.len);
+
+         s += block.len;
+      }
+      blocks[0].firstSep = sep;
+      sep = roundedSep;
+
+      ParallelFor(nBlocks, processBlock);
+
+      for (size_t ii = 0; ii < nBlocks; ++ii)
+      {
+         auto &block = blocks[ii];
+         mbDidSomething |= block.didSomething;
+         if (mbDidSomething) // RemoveClicks() actually did something.
+            track->Set((samplePtr) block.buffer.get(), floatSample,
+                       block.start, block.len);
+      }
 
       if (TrackProgress(count, s.as_double() /
                                len.as_double())) {
@@ -257,18 +308,20 @@ bool EffectClickRemoval::ProcessOne(int count, WaveTrack * track, sampleCount st
    return bResult;
 }
 
-bool EffectClickRemoval::RemoveClicks(size_t len, float *buffer)
+bool EffectClickRemoval::RemoveClicks(size_t len, float *buffer, int sep) const
 {
    bool bResult = false; // This effect usually does nothing.
    size_t i;
    size_t j;
    int left = 0;
 
-   float msw;
    int ww;
    int s2 = sep/2;
+   // Sums of squares are computed a chunk at a time, so whole chunks may
+   // read a little past the end
+   static const size_t kChunk = 64;
    Floats ms_seq{ len };
-   Floats b2{ len };
+   Floats b2{ len + kChunk + mClickWidth, true };
 
    for( i=0; i<len; i++)
       b2[i] = buffer[i]*buffer[i];
@@ -290,21 +343,40 @@ bool EffectClickRemoval::RemoveClicks(size_t len, float *buffer)
    for( i=0; i<len-sep; i++ ) {
       ms_seq[i] /= sep;
    }
+
+   /* The mean square of the ww samples after each position is summed for
+    * kChunk positions at a time.  Each sum adds the same terms in the same
+    * order as a sum for one position would, but the additions for
+    * neighbouring positions are independent, so they vectorize.  Sums
+    * past a repaired click are computed again from the repaired samples.
+    */
+   float msw[kChunk];
+   size_t chunkStart = 0, chunkEnd = 0;
+
    /* ww runs from about 4 to mClickWidth.  wrc is the reciprocal;
     * chosen so that integer roundoff doesn't clobber us.
     */
    int wrc;
    for(wrc=mClickWidth/4; wrc>=1; wrc /= 2) {
       ww = mClickWidth/wrc;
+      chunkStart = chunkEnd = 0;
 
       for( i=0; i<len-sep; i++ ){
-         msw = 0;
-         for( j=0; (int)j<ww; j++) {
-            msw += b2[i+s2+j];
+         if (i >= chunkEnd) {
+            chunkStart = i;
+            chunkEnd = std::min(i + kChunk, len - sep);
+            const float *const first = &b2[chunkStart + s2];
+            std::fill(msw, msw + kChunk, 0.0f);
+            for( j=0; (int)j<ww; j++) {
+               const float *const terms = first + j;
+               for (size_t k = 0; k < kChunk; k++)
+                  msw[k] += terms[k];
+            }
+            for (size_t k = 0; k < kChunk; k++)
+               msw[k] /= ww;
          }
-         msw /= ww;
 
-         if(msw >= mThresholdLevel * ms_seq[i]/10) {
+         if(msw[i - chunkStart] >= mThresholdLevel * ms_seq[i]/10) {
             if( left == 0 ) {
                left = i+s2;
             }
@@ -318,6 +390,7 @@ bool EffectClickRemoval::RemoveClicks(size_t len, float *buffer)
                   b2[j] = buffer[j]*buffer[j];
                }
                left=0;
+               chunkEnd = i + 1;
             } else if(left != 0) {
                left = 0;
             }
@@ -28,6 +28,7 @@
 #include "Compressor.h"
 
 #include <math.h>
+#include <algorithm>
 
 #include <wx/brush.h>
 #include <wx/dcclient.h>
@@ -64,6 +65,13 @@ Param( ReleaseTime,  double,  wxT("ReleaseTime"),   1.0,     1.0,     30.0,    1
 Param( Normalize,    bool,    wxT("Normalize"),     true,    false,   true,    1   );
 Param( UsePeak,      bool,    wxT("UsePeak"),       false,   false,   true,    1   );
 
+// Realtime processing looks this many seconds ahead, and so lags by twice it.
+// The realtime host does not compensate the latency of effects, so the
+// lookahead is kept short enough that the lag is no more than that of a
+// playback buffer.  Attacks longer than the lookahead are then ramped up
+// partly after the rise in level, rather than wholly before it as offline.
+static const double kLookaheadTime = 0.005;
+
 //----------------------------------------------------------------------------
 // EffectCompressor
 //----------------------------------------------------------------------------
@@ -82,9 +90,6 @@ EffectCompressor::EffectCompressor()
    mNormalize = DEF_Normalize;
    mUsePeak = DEF_UsePeak;
 
-   mThreshold = 0.25;
-   mNoiseFloor = 0.01;
-   mCompression = 0.5;
    mFollowLen = 0;
 
    SetLinearEffectFlag(false);
@@ -118,7 +123,70 @@ EffectType EffectCompressor::GetType()
    return EffectTypeProcess;
 }
 
+bool EffectCompressor::SupportsRealtime()
+{
+#if defined(EXPERIMENTAL_REALTIME_AUDACITY_EFFECTS)
+   return true;
+#else
+   return false;
+#endif
+}
+
 // EffectClientInterface implementation
+
+unsigned EffectCompressor::GetAudioInCount()
+{
+   return 1;
+}
+
+unsigned EffectCompressor::GetAudioOutCount()
+{
+   return 1;
+}
+
+bool EffectCompressor::RealtimeInitialize()
+{
+   SetBlockSize(512);
+
+   mSlaves.clear();
+
+   return true;
+}
+
+bool EffectCompressor::RealtimeAddProcessor(unsigned WXUNUSED(numChannels), float sampleRate)
+{
+   mSlaves.emplace_back();
+   auto &slave = mSlaves.back();
+
+   InstanceInit(slave, sampleRate);
+
+   slave.chunkLen = std::max<size_t>(1, (size_t)(sampleRate * kLookaheadTime));
+   slave.chunkPos = 0;
+   slave.primed = false;
+   slave.input.reinit(slave.chunkLen, true);
+   slave.previous.reinit(slave.chunkLen, true);
+   slave.output.reinit(slave.chunkLen, true);
+   slave.envelope.reinit(slave.chunkLen, true);
+   slave.previousEnvelope.reinit(slave.chunkLen, true);
+
+   return true;
+}
+
+bool EffectCompressor::RealtimeFinalize()
+{
+   mSlaves.clear();
+
+   return true;
+}
+
+size_t EffectCompressor::RealtimeProcess(int group,
+                                              float **inbuf,
+                                              float **outbuf,
+                                              size_t numSamples)
+{
+   return InstanceProcess(mSlaves[group], inbuf[0], outbuf[0], numSamples);
+}
+
 bool EffectCompressor::DefineParams( ShuttleParams & S ){
    S.SHUTTLE_PARAM( mThresholdDB, Threshold );
    S.SHUTTLE_PARAM( mNoiseFloorDB, NoiseFloor );
@@ -332,25 +400,7 @@ bool EffectCompressor::TransferDataFromWindow()
 
 bool EffectCompressor::NewTrackPass1()
 {
-   mThreshold = DB_TO_LINEAR(mThresholdDB);
-   mNoiseFloor = DB_TO_LINEAR(mNoiseFloorDB);
-   mNoiseCounter = 100;
-
-   mAttackInverseFactor = exp(log(mThreshold) / (mCurRate * mAttackTime + 0.5));
-   mAttackFactor = 1.0 / mAttackInverseFactor;
-   mDecayFactor = exp(log(mThreshold) / (mCurRate * mDecayTime + 0.5));
-
-   if(mRatio > 1)
-      mCompression = 1.0-1.0/mRatio;
-   else
-      mCompression = 0.0;
-
-   mLastLevel = mThreshold;
-
-   mCircleSize = 100;
-   mCircle.reinit( mCircleSize, true );
-   mCirclePos = 0;
-   mRMSSum = 0.0;
+   InstanceInit(mMaster, mCurRate);
 
    return true;
 }
@@ -398,24 +448,24 @@ bool EffectCompressor::TwoBufferProcessPass1
    // This makes sure that the initial value is well-chosen
    // buffer1 == NULL on the first and only the first call
    if (buffer1 == NULL) {
-      // Initialize the mLastLevel to the peak level in the first buffer
+      // Initialize the last level to the peak level in the first buffer
       // This avoids problems with large spike events near the beginning of the track
-      mLastLevel = mThreshold;
+      mMaster.lastLevel = mMaster.threshold;
       for(size_t i=0; i<len2; i++) {
-         if(mLastLevel < fabs(buffer2[i]))
-            mLastLevel = fabs(buffer2[i]);
+         if(mMaster.lastLevel < fabs(buffer2[i]))
+            mMaster.lastLevel = fabs(buffer2[i]);
       }
    }
 
    // buffer2 is NULL on the last and only the last call
    if(buffer2 != NULL) {
-      Follow(buffer2, mFollow2.get(), len2, mFollow1.get(), len1);
+      Follow(mMaster, buffer2, mFollow2.get(), len2, mFollow1.get(), len1);
    }
 
    if(buffer1 != NULL) {
-      for (size_t i = 0; i < len1; i++) {
-         buffer1[i] = DoCompression(buffer1[i], mFollow1[i]);
-      }
+      // Retain the maximum value for use in the normalization pass
+      mMax = std::max<double>(mMax,
+         Compress(mMaster, buffer1, mFollow1.get(), len1));
    }
 
 
@@ -441,31 +491,87 @@ bool EffectCompressor::ProcessPass2(float *buffer, size_t len)
    return true;
 }
 
-void EffectCompressor::FreshenCircle()
+// EffectCompressor implementation
+
+void EffectCompressor::InstanceInit(EffectCompressorState & state, double rate)
 {
-   // Recompute the RMS sum periodically to prevent accumulation of rounding errors
-   // during long waveforms
-   mRMSSum = 0;
-   for(size_t i=0; i<mCircleSize; i++)
-      mRMSSum += mCircle[i];
+   state.rate = rate;
+   UpdateFactors(state);
+
+   state.noiseCounter = 100;
+   state.lastLevel = state.threshold;
+
+   state.circleSize = 100;
+   state.circle.reinit( state.circleSize, true );
+   state.circlePos = 0;
 }
 
-float EffectCompressor::AvgCircle(float value)
+void EffectCompressor::UpdateFactors(EffectCompressorState & state)
 {
-   float level;
+   state.threshold = DB_TO_LINEAR(mThresholdDB);
+   state.noiseFloor = DB_TO_LINEAR(mNoiseFloorDB);
+
+   state.attackInverseFactor =
+      exp(log(state.threshold) / (state.rate * mAttackTime + 0.5));
+   state.attackFactor = 1.0 / state.attackInverseFactor;
+   state.decayFactor =
+      exp(log(state.threshold) / (state.rate * mDecayTime + 0.5));
+
+   if(mRatio > 1)
+      state.compression = 1.0-1.0/mRatio;
+   else
+      state.compression = 0.0;
+}
 
-   // Calculate current level from root-mean-squared of
-   // circular buffer ("RMS")
-   mRMSSum -= mCircle[mCirclePos];
-   mCircle[mCirclePos] = value*value;
-   mRMSSum += mCircle[mCirclePos];
-   level = sqrt(mRMSSum/mCircleSize);
-   mCirclePos = (mCirclePos+1)%mCircleSize;
+size_t EffectCompressor::InstanceProcess(EffectCompressorState & state,
+   const float *inBlock, float *outBlock, size_t blockLen)
+{
+   // The parameters may change during playback
+   UpdateFactors(state);
+
+   const auto chunkLen = state.chunkLen;
+   for (size_t done = 0; done < blockLen;) {
+      const auto len = std::min(blockLen - done, chunkLen - state.chunkPos);
+
+      // Take the input before giving the output, which may be in the same
+      // buffer
+      std::copy(inBlock + done, inBlock + done + len,
+                state.input.get() + state.chunkPos);
+      std::copy(state.output.get() + state.chunkPos,
+                state.output.get() + state.chunkPos + len,
+                outBlock + done);
+      state.chunkPos += len;
+      done += len;
+
+      if (state.chunkPos == chunkLen) {
+         state.chunkPos = 0;
+
+         // The envelope of the new chunk may raise that of the previous
+         // one, so only now is the previous one ready to compress, and
+         // play while the next chunk is collected
+         if (state.primed) {
+            Follow(state, state.input.get(), state.envelope.get(), chunkLen,
+                   state.previousEnvelope.get(), chunkLen);
+            Compress(state, state.previous.get(),
+                     state.previousEnvelope.get(), chunkLen);
+            state.output.swap(state.previous);
+         }
+         else {
+            Follow(state, state.input.get(), state.envelope.get(), chunkLen,
+                   NULL, 0);
+            state.primed = true;
+         }
+         state.previous.swap(state.input);
+         state.previousEnvelope.swap(state.envelope);
+      }
+   }
 
-   return level;
+   return blockLen;
 }
 
-void EffectCompressor::Follow(float *buffer, float *env, size_t len, float *previous, size_t previous_len)
+void EffectCompressor::Follow(EffectCompressorState & state,
+   const float *buffer, float *env, size_t len,
+   float *previous, size_t previous_len)
 {
    /*
 
@@ -503,41 +609,70 @@ void EffectCompressor::Follow(float *buffer, float *env, size_t len, float *prev
    */
    double level,last;
 
-   if(!mUsePeak) {
-      // Update RMS sum directly from the circle buffer
-      // to avoid accumulation of rounding errors
-      FreshenCircle();
+   // First detect the level of each sample, into env, in a loop apart from
+   // the envelope recurrences below
+   if(mUsePeak) {
+      for(size_t i=0; i<len; i++)
+         env[i] = fabs(buffer[i]);
    }
-   // First apply a peak detect with the requested decay rate
-   last = mLastLevel;
+   else {
+      // Calculate the level from the root-mean-square of the circular
+      // buffer of squares, summing it afresh for each buffer to prevent
+      // accumulation of rounding errors during long waveforms
+      double *circle = state.circle.get();
+      const auto circleSize = state.circleSize;
+      auto circlePos = state.circlePos;
+      double sum = 0;
+      for(size_t i=0; i<circleSize; i++)
+         sum += circle[i];
+      for(size_t i=0; i<len; i++) {
+         const double square = buffer[i] * buffer[i];
+         sum += square - circle[circlePos];
+         circle[circlePos] = square;
+         if (++circlePos == circleSize)
+            circlePos = 0;
+         env[i] = sum;
+      }
+      state.circlePos = circlePos;
+
+      const double scale = 1.0 / circleSize;
+      for(size_t i=0; i<len; i++)
+         env[i] = sqrt(std::max(0.0, env[i] * scale));
+   }
+
+   // Then apply a peak detect with the requested decay rate
+   const auto threshold = state.threshold;
+   const auto noiseFloor = state.noiseFloor;
+   const auto decayFactor = state.decayFactor;
+   const auto attackFactor = state.attackFactor;
+   const auto attackInverseFactor = state.attackInverseFactor;
+   auto noiseCounter = state.noiseCounter;
+   last = state.lastLevel;
    for(size_t i=0; i<len; i++) {
-      if(mUsePeak)
-         level = fabs(buffer[i]);
-      else // use RMS
-         level = AvgCircle(buffer[i]);
+      level = env[i];
       // Don't increase gain when signal is continuously below the noise floor
-      if(level < mNoiseFloor) {
-         mNoiseCounter++;
+      if(level < noiseFloor) {
+         noiseCounter++;
       } else {
-         mNoiseCounter = 0;
+         noiseCounter = 0;
       }
-      if(mNoiseCounter < 100) {
-         last *= mDecayFactor;
-         if(last < mThreshold)
-            last = mThreshold;
+      if(noiseCounter < 100) {
+         last *= decayFactor;
+         if(last < threshold)
+            last = threshold;
          if(level > last)
             last = level;
       }
       env[i] = last;
    }
-   mLastLevel = last;
+   state.noiseCounter = noiseCounter;
+   state.lastLevel = last;
 
    // Next do the same process in reverse direction to get the requested attack rate
-   last = mLastLevel;
    for(size_t i = len; i--;) {
-      last *= mAttackInverseFactor;
-      if(last < mThreshold)
-         last = mThreshold;
+      last *= attackInverseFactor;
+      if(last < threshold)
+         last = threshold;
       if(env[i] < last)
          env[i] = last;
       else
@@ -547,9 +682,9 @@ void EffectCompressor::Follow(float *buffer, float *env, size_t len, float *prev
    if((previous != NULL) && (previous_len > 0)) {
       // If the previous envelope was passed, propagate the rise back until we intersect
       for(size_t i = previous_len; i--;) {
-         last *= mAttackInverseFactor;
-         if(last < mThreshold)
-            last = mThreshold;
+         last *= attackInverseFactor;
+         if(last < threshold)
+            last = threshold;
          if(previous[i] < last)
             previous[i] = last;
          else // Intersected the previous envelope buffer, so we are finished
@@ -559,7 +694,7 @@ void EffectCompressor::Follow(float *buffer, float *env, size_t len, float *prev
       // until we intersect the desired envelope
       last = previous[0];
       for(size_t i=1; i<previous_len; i++) {
-         last *= mAttackFactor;
+         last *= attackFactor;
          if(previous[i] > last)
             previous[i] = last;
          else // Intersected the desired envelope, so we are finished
@@ -567,33 +702,42 @@ void EffectCompressor::Follow(float *buffer, float *env, size_t len, float *prev
       }
       // If we still didn't intersect, then continue ramp up into current buffer
       for(size_t i=0; i<len; i++) {
-         last *= mAttackFactor;
-         if(buffer[i] > last)
-            buffer[i] = last;
+         last *= attackFactor;
+         if(env[i] > last)
+            env[i] = last;
          else // Finally got an intersect
             return;
       }
-      // If we still didn't intersect, then reset mLastLevel
-      mLastLevel = last;
+      // If we still didn't intersect, then reset the last level
+      state.lastLevel = last;
    }
 }
 
-float EffectCompressor::DoCompression(float value, double env)
+float EffectCompressor::Compress(EffectCompressorState & state,
+   float *buffer, const float *env, size_t len)
 {
-   float out;
-   if(mUsePeak) {
-      // Peak values map 1.0 to 1.0 - 'upward' compression
-      out = value * pow(1.0/env, mCompression);
-   } else {
-      // With RMS-based compression don't change values below mThreshold - 'downward' compression
-      out = value * pow(mThreshold/env, mCompression);
+   // Peak values map 1.0 to 1.0 - 'upward' compression.
+   // With RMS-based compression don't change values below the threshold -
+   // 'downward' compression
+   const double base = mUsePeak ? 1.0 : state.threshold;
+
+   // The envelope often holds steady, as at the threshold, so compute the
+   // gain only where it changes
+   float lastEnv = -1;
+   double gain = 1.0;
+   for (size_t i = 0; i < len; i++) {
+      if (env[i] != lastEnv) {
+         lastEnv = env[i];
+         gain = pow(base / lastEnv, state.compression);
+      }
+      buffer[i] = buffer[i] * gain;
    }
 
-   // Retain the maximum value for use in the normalization pass
-   if(mMax < fabs(out))
-      mMax = fabs(out);
+   float max = 0;
+   for (size_t i = 0; i < len; i++)
+      max = std::max(max, fabsf(buffer[i]));
 
-   return out;
+   return max;
 }
 
 void EffectCompressor::OnSlider(wxCommandEvent & WXUNUSED(evt))
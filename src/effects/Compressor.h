@@ -21,6 +21,8 @@
 #include <wx/window.h>
 #include "../widgets/wxPanelWrapper.h"
 
+#include <vector>
+
 #include "TwoPassSimpleMono.h"
 #include "../SampleFormat.h"
 
@@ -29,6 +31,34 @@ class ShuttleGui;
 
 #define COMPRESSOR_PLUGIN_SYMBOL ComponentInterfaceSymbol{ XO("Compressor") }
 
+class EffectCompressorState
+{
+public:
+   double rate;
+   double threshold;
+   double noiseFloor;
+   double compression;
+   double attackFactor;
+   double attackInverseFactor;
+   double decayFactor;
+   int noiseCounter;
+   double lastLevel;
+
+   // Squares of the latest samples, for the RMS level
+   Doubles circle;
+   size_t circleSize;
+   size_t circlePos;
+
+   // For realtime processing only: a chunk of lookahead is collected in
+   // input, while previous and its envelope wait on it, and output plays
+   // the chunk before that
+   size_t chunkLen;
+   size_t chunkPos;
+   bool primed;
+   Floats input, previous, output;
+   Floats envelope, previousEnvelope;
+};
+
 class EffectCompressor final : public EffectTwoPassSimpleMono
 {
 public:
@@ -45,9 +75,19 @@ public:
    // EffectDefinitionInterface implementation
 
    EffectType GetType() override;
+   bool SupportsRealtime() override;
 
    // EffectClientInterface implementation
 
+   unsigned GetAudioInCount() override;
+   unsigned GetAudioOutCount() override;
+   bool RealtimeInitialize() override;
+   bool RealtimeAddProcessor(unsigned numChannels, float sampleRate) override;
+   bool RealtimeFinalize() override;
+   size_t RealtimeProcess(int group,
+                               float **inbuf,
+                               float **outbuf,
+                               size_t numSamples) override;
    bool DefineParams( ShuttleParams & S ) override;
    bool GetAutomationParameters(CommandParameters & parms) override;
    bool SetAutomationParameters(CommandParameters & parms) override;
@@ -72,19 +112,23 @@ protected:
 private:
    // EffectCompressor implementation
 
-   void FreshenCircle();
-   float AvgCircle(float x);
-   void Follow(float *buffer, float *env, size_t len, float *previous, size_t previous_len);
-   float DoCompression(float x, double env);
+   void InstanceInit(EffectCompressorState & state, double rate);
+   void UpdateFactors(EffectCompressorState & state);
+   size_t InstanceProcess(EffectCompressorState & state,
+                          const float *inBlock, float *outBlock, size_t blockLen);
+
+   void Follow(EffectCompressorState & state, const float *buffer,
+               float *env, size_t len, float *previous, size_t previous_len);
+   // Returns the greatest magnitude of the compressed samples
+   float Compress(EffectCompressorState & state,
+                  float *buffer, const float *env, size_t len);
 
    void OnSlider(wxCommandEvent & evt);
    void UpdateUI();
 
 private:
-   double    mRMSSum;
-   size_t    mCircleSize;
-   size_t    mCirclePos;
-   Doubles   mCircle;
+   EffectCompressorState mMaster;
+   std::vector<EffectCompressorState> mSlaves;
 
    double    mAttackTime;
    double    mThresholdDB;
@@ -94,15 +138,6 @@ private:
    bool      mUsePeak;
 
    double    mDecayTime;   // The "Release" time.
-   double    mAttackFactor;
-   double    mAttackInverseFactor;
-   double    mDecayFactor;
-   double    mThreshold;
-   double    mCompression;
-   double    mNoiseFloor;
-   int       mNoiseCounter;
-   double    mGain;
-   double    mLastLevel;
    Floats mFollow1, mFollow2;
    size_t    mFollowLen;
 
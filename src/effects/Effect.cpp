@@ -43,6 +43,7 @@ greater use in future.
 #include "../LabelTrack.h"
 #include "../Menus.h"
 #include "../Mix.h"
+#include "../PlaybackStream.h"
 #include "../Prefs.h"
 #include "../Project.h"
 #include "../ShuttleGui.h"
@@ -1737,6 +1738,11 @@ bool Effect::ProcessTrack(int count,
          }
       }
 
+      // Let a preview play each block as soon as it is processed
+      if (mPreviewStream && curBlockSize > 0 && chans > 0 &&
+          mNumChannels == mPreviewStream->GetChannels())
+         StreamPreview(outBufPos.get(), chans, curBlockSize);
+
       // Adjust the number of samples in the output buffers
       outputBufferCnt += curBlockSize;
 
@@ -1876,6 +1882,22 @@ bool Effect::ProcessTrack(int count,
    return rc;
 }
 
+void Effect::StreamPreview(
+   const float *const *buffers, unsigned nBuffers, size_t len)
+{
+   // As when the track is written, the output of an effect with fewer
+   // outputs than the track has channels goes to the other channels too
+   const float *channels[2] = { buffers[0], buffers[nBuffers > 1 ? 1 : 0] };
+   mPreviewStream->Put(channels, len);
+
+   if (mStartPreviewStream) {
+      // Start playback just once, with the first output
+      auto start = std::move(mStartPreviewStream);
+      mStartPreviewStream = nullptr;
+      start();
+   }
+}
+
 void Effect::End()
 {
 }
@@ -2571,6 +2593,19 @@ void Effect::Preview(bool dryOnly)
    // Update track/group counts
    CountWaveTracks();
 
+   // Playback may start while the effect is still processing, so stop it
+   // however we leave
+   int token = 0;
+   auto cleanup3 = finally( [&] {
+      if (token) {
+         gAudioIO->StopStream();
+
+         while (gAudioIO->IsBusy()) {
+            ::wxMilliSleep(100);
+         }
+      }
+   } );
+
    // Apply effect
    if (!dryOnly) {
       ProgressDialog progress{
@@ -2582,7 +2617,45 @@ void Effect::Preview(bool dryOnly)
 
       auto vr2 = valueRestorer( mIsPreview, true );
 
+      // An effect processed by blocks in ProcessTrack() can be heard from
+      // its first output on, if it processes all channels of a single track
+      // together.  Otherwise, nothing is put to the stream, playback does
+      // not start here, and the preview plays after processing as usual.
+      // AudioIO plays stream samples without resampling, so the track must
+      // already be at the playback rate.
+      std::shared_ptr<PlaybackStream> stream;
+      auto playbackTracks = GetAllPlaybackTracks(*mTracks, true);
+      const auto &channels = playbackTracks.playbackTracks;
+      if (GetType() == EffectTypeProcess &&
+          !channels.empty() && channels.size() <= 2 &&
+          channels.size() == TrackList::Channels(channels[0].get()).size() &&
+          std::all_of(channels.begin(), channels.end(),
+             [&](const std::shared_ptr<WaveTrack> &channel)
+                { return channel->GetRate() == rate; })) {
+         const double streamT1 = std::min(mT0 + previewLen, mT1);
+         stream = std::make_shared<PlaybackStream>(channels.size(),
+            (size_t)((streamT1 - mT0 + 1.0) * rate));
+         mPreviewStream = stream;
+         mStartPreviewStream = [&, streamT1] {
+            AudioIOStartStreamOptions options { rate };
+            options.pPlaybackStream = stream;
+            token =
+               gAudioIO->StartStream(playbackTracks, mT0, streamT1, options);
+            if (!token)
+               // Try again after processing, and report any error then
+               mPreviewStream.reset();
+         };
+      }
+      auto cleanup4 = finally( [&] {
+         mPreviewStream.reset();
+         mStartPreviewStream = nullptr;
+      } );
+
       success = Process();
+
+      if (token)
+         // Let playback drain the stream, then stop
+         stream->Finish();
    }
 
    if (success)
@@ -2593,10 +2666,12 @@ void Effect::Preview(bool dryOnly)
       // than previewLen, so take the min.
       t1 = std::min(mT0 + previewLen, mT1);
 
-      // Start audio playing
-      AudioIOStartStreamOptions options { rate };
-      int token =
-         gAudioIO->StartStream(tracks, mT0, t1, options);
+      if (!token) {
+         // Start audio playing
+         AudioIOStartStreamOptions options { rate };
+         token =
+            gAudioIO->StartStream(tracks, mT0, t1, options);
+      }
 
       if (token) {
          auto previewing = ProgressResult::Success;
@@ -2612,12 +2687,6 @@ void Effect::Preview(bool dryOnly)
                previewing = progress.Update(gAudioIO->GetStreamTime() - mT0, t1 - mT0);
             }
          }
-
-         gAudioIO->StopStream();
-
-         while (gAudioIO->IsBusy()) {
-            ::wxMilliSleep(100);
-         }
       }
       else {
          ShowErrorDialog(FocusDialog, _("Error"),
@@ -14,6 +14,7 @@
 
 #include "../Audacity.h"
 #include "../MemoryX.h"
+#include <functional>
 #include <set>
 
 #include "../MemoryX.h"
@@ -50,6 +51,7 @@ class AudacityProject;
 class LabelTrack;
 class SelectedRegion;
 class EffectUIHost;
+class PlaybackStream;
 class Track;
 class TrackList;
 class TrackFactory;
@@ -496,6 +498,8 @@ protected:
                      FloatBuffers &outBuffer,
                      ArrayOf< float * > &inBufPos,
                      ArrayOf< float *> &outBufPos);
+   void StreamPreview(
+      const float *const *buffers, unsigned nBuffers, size_t len);
 
  //
  // private data
@@ -515,6 +519,10 @@ private:
    NumericFormatId mDurationFormat;
 
    bool mIsPreview;
+   // While previewing, ProcessTrack() puts its output in mPreviewStream,
+   // and calls mStartPreviewStream to begin playback as soon as there is some
+   std::shared_ptr<PlaybackStream> mPreviewStream;
+   std::function<void()> mStartPreviewStream;
 
    bool mUIDebug;
 
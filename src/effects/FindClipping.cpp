@@ -154,49 +154,14 @@ bool EffectFindClipping::ProcessOne(LabelTrack * lt,
                                     sampleCount start,
                                     sampleCount len)
 {
-   bool bGoodResult = true;
-   size_t blockSize = (mStart * 1000);
-
    if (len < mStart) {
       return true;
    }
 
-   Floats buffer;
-   try {
-      // mStart should be positive.
-      // if we are throwing bad_alloc and mStart is negative, find out why.
-      if (mStart < 0 || (int)blockSize < mStart)
-         // overflow
-         throw std::bad_alloc{};
-      buffer.reinit(blockSize);
-   }
-   catch( const std::bad_alloc & ) {
-      Effect::MessageBox(_("Requested value exceeds memory capacity."));
-      return false;
-   }
-
-   float *ptr = buffer.get();
-
    decltype(len) s = 0, startrun = 0, stoprun = 0, samps = 0;
-   decltype(blockSize) block = 0;
    double startTime = -1.0;
 
-   while (s < len) {
-      if (block == 0) {
-         if (TrackProgress(count,
-                           s.as_double() /
-                           len.as_double() )) {
-            bGoodResult = false;
-            break;
-         }
-
-         block = limitSampleBufferSize( blockSize, len - s );
-
-         wt->Get((samplePtr)buffer.get(), floatSample, start + s, block);
-         ptr = buffer.get();
-      }
-
-      float v = fabs(*ptr++);
+   auto step = [&](float v) {
       if (v >= MAX_AUDIO) {
          if (startrun == 0) {
             startTime = wt->LongSamplesToTime(start + s);
@@ -229,10 +194,34 @@ bool EffectFindClipping::ProcessOne(LabelTrack * lt,
       }
 
       s++;
-      block--;
-   }
+   };
+
+   // Most of a track is usually well below full scale, and the block
+   // summaries show it without reading the samples
+   return wt->ScanWithSummaries(start, len,
+      [](float min, float max) {
+         return max < MAX_AUDIO && min > -MAX_AUDIO;
+      },
+      [&](sampleCount, sampleCount runLen, const float *samples) {
+         if (TrackProgress(count,
+                           s.as_double() /
+                           len.as_double() ))
+            return false;
 
-   return bGoodResult;
+         if (samples) {
+            for (size_t i = 0, n = runLen.as_size_t(); i < n; ++i)
+               step(fabs(samples[i]));
+         }
+         else {
+            // None of the run is clipped.  Once no run of clipping is
+            // open, such samples change nothing but the position.
+            const auto runEnd = s + runLen;
+            while (s < runEnd && startrun != 0)
+               step(0.0f);
+            s = runEnd;
+         }
+         return true;
+      });
 }
 
 void EffectFindClipping::PopulateOrExchange(ShuttleGui & S)
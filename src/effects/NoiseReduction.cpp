@@ -43,6 +43,7 @@
 
 #include "../ShuttleGui.h"
 #include "../widgets/HelpSystem.h"
+#include "../ParallelFor.h"
 #include "../Prefs.h"
 
 #include "../WaveTrack.h"
@@ -272,21 +273,35 @@ private:
                    TrackFactory &factory,
                    int count, WaveTrack *track,
                    sampleCount start, sampleCount len);
+   bool ReduceConcurrently(EffectNoiseReduction &effect,
+                   Statistics &statistics,
+                   int count, WaveTrack *track,
+                   sampleCount start, sampleCount len,
+                   WaveTrack &outputTrack);
+
+   // Concurrent segments overlap their predecessors by this many steps
+   size_t WarmUpSteps() const;
+   size_t SegmentLength() const;
 
    void StartNewTrack();
-   void ProcessSamples(Statistics &statistics,
-      WaveTrack *outputTrack, size_t len, float *buffer);
+   void ProcessSamples(Statistics &statistics, size_t len, float *buffer);
    void FillFirstHistoryWindow();
    void ApplyFreqSmoothing(FloatVector &gains);
    void GatherStatistics(Statistics &statistics);
    inline bool Classify(const Statistics &statistics, int band);
-   void ReduceNoise(const Statistics &statistics, WaveTrack *outputTrack);
+   void ReduceNoise(const Statistics &statistics);
    void RotateHistoryWindows();
    void FinishTrackStatistics(Statistics &statistics);
-   void FinishTrack(Statistics &statistics, WaveTrack *outputTrack);
+   void FinishTrack(Statistics &statistics);
 
 private:
 
+   // Kept to make more workers for concurrent segments
+   const Settings mSettings;
+#ifdef EXPERIMENTAL_SPECTRAL_EDITING
+   const double mF0, mF1;
+#endif
+
    const bool mDoProfile;
 
    const double mSampleRate;
@@ -327,6 +342,10 @@ private:
    unsigned  mNWindowsToExamine;
    unsigned  mCenter;
    unsigned  mHistoryLen;
+   unsigned  mNReleaseBlocks;
+
+   // Samples reduced but not yet taken by ProcessOne
+   FloatVector mOutput;
 
    struct Record
    {
@@ -698,26 +717,32 @@ void EffectNoiseReduction::Worker::ApplyFreqSmoothing(FloatVector &gains)
    if (mFreqSmoothingBins == 0)
       return;
 
-   {
-      float *pScratch = &mFreqSmoothingScratch[0];
-      std::fill(pScratch, pScratch + mSpectrumSize, 0.0f);
-   }
-
    for (size_t ii = 0; ii < mSpectrumSize; ++ii)
       gains[ii] = log(gains[ii]);
 
+   // Slide a window of the logs across the bins, rather than summing the
+   // window over again for each bin.  The running sum is double so that its
+   // rounding does not build up across the spectrum.
+   const int nBins = mSpectrumSize;
+   const int halfWidth = mFreqSmoothingBins;
+   double sum = 0.0;
+   for (int jj = 0, j1 = std::min(nBins - 1, halfWidth); jj <= j1; ++jj)
+      sum += gains[jj];
+
    // ii must be signed
-   for (int ii = 0; ii < (int)mSpectrumSize; ++ii) {
-      const int j0 = std::max(0, ii - (int)mFreqSmoothingBins);
-      const int j1 = std::min(mSpectrumSize - 1, ii + mFreqSmoothingBins);
-      for(int jj = j0; jj <= j1; ++jj) {
-         mFreqSmoothingScratch[ii] += gains[jj];
-      }
-      mFreqSmoothingScratch[ii] /= (j1 - j0 + 1);
+   float *pScratch = &mFreqSmoothingScratch[0];
+   for (int ii = 0; ii < nBins; ++ii) {
+      const int j0 = std::max(0, ii - halfWidth);
+      const int j1 = std::min(nBins - 1, ii + halfWidth);
+      pScratch[ii] = sum / (j1 - j0 + 1);
+      if (ii + halfWidth + 1 < nBins)
+         sum += gains[ii + halfWidth + 1];
+      if (ii - halfWidth >= 0)
+         sum -= gains[ii - halfWidth];
    }
 
    for (size_t ii = 0; ii < mSpectrumSize; ++ii)
-      gains[ii] = exp(mFreqSmoothingScratch[ii]);
+      gains[ii] = exp(pScratch[ii]);
 }
 
 EffectNoiseReduction::Worker::Worker
@@ -726,7 +751,12 @@ EffectNoiseReduction::Worker::Worker
 , double f0, double f1
 #endif
 )
-: mDoProfile(settings.mDoProfile)
+: mSettings(settings)
+#ifdef EXPERIMENTAL_SPECTRAL_EDITING
+, mF0(f0), mF1(f1)
+#endif
+
+, mDoProfile(settings.mDoProfile)
 
 , mSampleRate(sampleRate)
 
@@ -769,6 +799,7 @@ EffectNoiseReduction::Worker::Worker
    const double noiseGain = -settings.mNoiseGain;
    const unsigned nAttackBlocks = 1 + (int)(settings.mAttackTime * sampleRate / mStepSize);
    const unsigned nReleaseBlocks = 1 + (int)(settings.mReleaseTime * sampleRate / mStepSize);
+   mNReleaseBlocks = nReleaseBlocks;
    // Applies to amplitudes, divide by 20:
    mNoiseAttenFactor = DB_TO_LINEAR(noiseGain);
    // Apply to gain factors which apply to amplitudes, divide by 20:
@@ -914,8 +945,7 @@ void EffectNoiseReduction::Worker::StartNewTrack()
 }
 
 void EffectNoiseReduction::Worker::ProcessSamples
-(Statistics &statistics, WaveTrack *outputTrack,
- size_t len, float *buffer)
+(Statistics &statistics, size_t len, float *buffer)
 {
    while (len && mOutStepCount * mStepSize < mInSampleCount) {
       auto avail = std::min(len, mWindowSize - mInWavePos);
@@ -929,7 +959,7 @@ void EffectNoiseReduction::Worker::ProcessSamples
          if (mDoProfile)
             GatherStatistics(statistics);
          else
-            ReduceNoise(statistics, outputTrack);
+            ReduceNoise(statistics);
          ++mOutStepCount;
          RotateHistoryWindows();
 
@@ -1012,8 +1042,7 @@ void EffectNoiseReduction::Worker::FinishTrackStatistics(Statistics &statistics)
    statistics.mTotalWindows = denom;
 }
 
-void EffectNoiseReduction::Worker::FinishTrack
-(Statistics &statistics, WaveTrack *outputTrack)
+void EffectNoiseReduction::Worker::FinishTrack(Statistics &statistics)
 {
    // Keep flushing empty input buffers through the history
    // windows until we've output exactly as many samples as
@@ -1025,7 +1054,7 @@ void EffectNoiseReduction::Worker::FinishTrack
    FloatVector empty(mStepSize);
 
    while (mOutStepCount * mStepSize < mInSampleCount) {
-      ProcessSamples(statistics, outputTrack, mStepSize, &empty[0]);
+      ProcessSamples(statistics, mStepSize, &empty[0]);
    }
 }
 
@@ -1135,8 +1164,7 @@ bool EffectNoiseReduction::Worker::Classify(const Statistics &statistics, int ba
    }
 }
 
-void EffectNoiseReduction::Worker::ReduceNoise
-(const Statistics &statistics, WaveTrack *outputTrack)
+void EffectNoiseReduction::Worker::ReduceNoise(const Statistics &statistics)
 {
    // Raise the gain for elements in the center of the sliding history
    // or, if isolating noise, zero out the non-noise
@@ -1273,7 +1301,7 @@ void EffectNoiseReduction::Worker::ReduceNoise
       float *buffer = &mOutOverlapBuffer[0];
       if (mOutStepCount >= 0) {
          // Output the first portion of the overlap buffer, they're done
-         outputTrack->Append((samplePtr)buffer, floatSample, mStepSize);
+         mOutput.insert(mOutput.end(), buffer, buffer + mStepSize);
       }
 
       // Shift the remainder over.
@@ -1295,37 +1323,52 @@ bool EffectNoiseReduction::Worker::ProcessOne
    if(!mDoProfile)
       outputTrack = factory.NewWaveTrack(track->GetSampleFormat(), track->GetRate());
 
-   auto bufferSize = track->GetMaxBlockSize();
-   FloatVector buffer(bufferSize);
-
    bool bLoopSuccess = true;
-   auto samplePos = start;
-   while (bLoopSuccess && samplePos < start + len) {
-      //Get a blockSize of samples (smaller than the size of the buffer)
-      const auto blockSize = limitSampleBufferSize(
-         track->GetBestBlockSize(samplePos),
-         start + len - samplePos
-      );
-
-      //Get the samples from the track and put them in the buffer
-      track->Get((samplePtr)&buffer[0], floatSample, samplePos, blockSize);
-      samplePos += blockSize;
-
-      mInSampleCount += blockSize;
-      ProcessSamples(statistics, outputTrack.get(), blockSize, &buffer[0]);
+   if (!mDoProfile &&
+       ParallelForConcurrency() > 1 &&
+       len > sampleCount{ 2 * SegmentLength() })
+      bLoopSuccess = ReduceConcurrently(effect, statistics,
+         count, track, start, len, *outputTrack);
+   else {
+      auto bufferSize = track->GetMaxBlockSize();
+      FloatVector buffer(bufferSize);
+
+      auto samplePos = start;
+      while (bLoopSuccess && samplePos < start + len) {
+         //Get a blockSize of samples (smaller than the size of the buffer)
+         const auto blockSize = limitSampleBufferSize(
+            track->GetBestBlockSize(samplePos),
+            start + len - samplePos
+         );
+
+         //Get the samples from the track and put them in the buffer
+         track->Get((samplePtr)&buffer[0], floatSample, samplePos, blockSize);
+         samplePos += blockSize;
+
+         mInSampleCount += blockSize;
+         ProcessSamples(statistics, blockSize, &buffer[0]);
+         if (outputTrack && !mOutput.empty()) {
+            outputTrack->Append((samplePtr)&mOutput[0], floatSample, mOutput.size());
+            mOutput.clear();
+         }
 
-      // Update the Progress meter, let user cancel
-      bLoopSuccess = 
-         !effect.TrackProgress(count,
-                               ( samplePos - start ).as_double() /
-                               len.as_double() );
-   }
+         // Update the Progress meter, let user cancel
+         bLoopSuccess = 
+            !effect.TrackProgress(count,
+                                  ( samplePos - start ).as_double() /
+                                  len.as_double() );
+      }
 
-   if (bLoopSuccess) {
-      if (mDoProfile)
-         FinishTrackStatistics(statistics);
-      else
-         FinishTrack(statistics, &*outputTrack);
+      if (bLoopSuccess) {
+         if (mDoProfile)
+            FinishTrackStatistics(statistics);
+         else {
+            FinishTrack(statistics);
+            if (!mOutput.empty())
+               outputTrack->Append((samplePtr)&mOutput[0], floatSample, mOutput.size());
+         }
+      }
+      mOutput.clear();
    }
 
    if (bLoopSuccess && !mDoProfile) {
@@ -1344,6 +1387,102 @@ bool EffectNoiseReduction::Worker::ProcessOne
    return bLoopSuccess;
 }
 
+size_t EffectNoiseReduction::Worker::WarmUpSteps() const
+{
+   // Windows that must be analyzed before a step of output no longer depends
+   // on what preceded them:  those partly zero-padded, those primed into the
+   // history, those examined to classify the center, and those through which
+   // the release of a gain decays to the floor (with spares for rounding).
+   // The attack reaches only back toward earlier windows.
+   return mStepsPerWindow + mHistoryLen + mNWindowsToExamine
+      + mNReleaseBlocks + 2;
+}
+
+size_t EffectNoiseReduction::Worker::SegmentLength() const
+{
+   // Long enough that warming up costs little more than a tenth of the work
+   return 16 * WarmUpSteps() * mStepSize;
+}
+
+bool EffectNoiseReduction::Worker::ReduceConcurrently
+(EffectNoiseReduction &effect, Statistics &statistics,
+ int count, WaveTrack *track, sampleCount start, sampleCount len,
+ WaveTrack &outputTrack)
+{
+   // Divide the track into segments, each reduced by its own worker.  Every
+   // worker but the first starts a whole number of steps before its segment,
+   // so it windows the same samples as a serial pass would, and its history
+   // has become identical to that of the serial pass by the segment's first
+   // step.  The output is then the same, sample for sample.
+   const size_t warmUp = WarmUpSteps() * mStepSize;
+   // Input needed past the end of a segment, before its last step leaves the
+   // history queue
+   const size_t lookAhead = (mHistoryLen + mStepsPerWindow) * mStepSize;
+   const size_t segmentLength = SegmentLength();
+   const size_t nThreads = ParallelForConcurrency();
+
+   struct Segment {
+      sampleCount inputStart;
+      size_t skip; // output samples preceding the segment
+      size_t len;
+      bool last;
+      FloatVector input;
+      std::unique_ptr<Worker> worker;
+   };
+
+   const auto end = start + len;
+   auto segmentStart = start;
+   while (segmentStart < end) {
+      // Gather the input of one segment per thread.  Reading of the track
+      // stays on this thread.
+      std::vector<Segment> segments;
+      while (segments.size() < nThreads && segmentStart < end) {
+         segments.emplace_back();
+         auto &segment = segments.back();
+         segment.skip = limitSampleBufferSize(warmUp, segmentStart - start);
+         segment.inputStart = segmentStart - segment.skip;
+         segment.len = limitSampleBufferSize(segmentLength, end - segmentStart);
+         const auto inputEnd =
+            std::min(end, segmentStart + segment.len + lookAhead);
+         segment.last = (inputEnd == end);
+         segment.input.resize((inputEnd - segment.inputStart).as_size_t());
+         track->Get((samplePtr)&segment.input[0], floatSample,
+            segment.inputStart, segment.input.size());
+         segment.worker = std::make_unique<Worker>(mSettings, mSampleRate
+#ifdef EXPERIMENTAL_SPECTRAL_EDITING
+            , mF0, mF1
+#endif
+         );
+         segmentStart += segment.len;
+      }
+
+      ParallelFor(segments.size(), [&statistics, &segments](size_t ii) {
+         auto &segment = segments[ii];
+         auto &worker = *segment.worker;
+         worker.StartNewTrack();
+         worker.mInSampleCount = segment.input.size();
+         worker.ProcessSamples(statistics,
+            segment.input.size(), &segment.input[0]);
+         if (segment.last)
+            worker.FinishTrack(statistics);
+      } );
+
+      for (auto &segment : segments) {
+         const auto &output = segment.worker->mOutput;
+         wxASSERT(output.size() >= segment.skip + segment.len);
+         outputTrack.Append((samplePtr)&output[segment.skip],
+            floatSample, segment.len);
+      }
+
+      // Update the Progress meter, let user cancel
+      if (effect.TrackProgress(count,
+            ( segmentStart - start ).as_double() / len.as_double() ))
+         return false;
+   }
+
+   return true;
+}
+
 //----------------------------------------------------------------------------
 // EffectNoiseReduction::Dialog
 //----------------------------------------------------------------------------
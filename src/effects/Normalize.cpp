@@ -20,11 +20,14 @@
 #include "Normalize.h"
 
 #include <math.h>
+#include <algorithm>
+#include <limits>
 
 #include <wx/intl.h>
 #include <wx/valgen.h>
 
 #include "../Internat.h"
+#include "../ParallelFor.h"
 #include "../Prefs.h"
 #include "../ShuttleGui.h"
 #include "../WaveTrack.h"
@@ -250,48 +253,17 @@ bool EffectNormalize::Process()
       if (mCurT1 > mCurT0) {
          wxString trackName = track->GetName();
 
+         // One pass over the channels together collects offsets and extent
          float extent;
-#ifdef EXPERIMENTAL_R128_NORM
-         if (mUseLoudness)
-            // Loudness: use sum of both tracks.
-            // As a result, stereo tracks appear about 3 LUFS louder,
-            // as specified.
-            extent = 0;
-         else
-#endif
-            // Will compute a maximum
-            extent = std::numeric_limits<float>::lowest();
          std::vector<float> offsets;
-
-         wxString msg;
-         if (range.size() == 1)
-            // mono or 'stereo tracks independently'
-            msg = topMsg +
-               wxString::Format( _("Analyzing: %s"), trackName );
-         else
-            msg = topMsg +
-               // TODO: more-than-two-channels-message
-               wxString::Format( _("Analyzing first track of stereo pair: %s"), trackName);
-         
-         // Analysis loop over channels collects offsets and extent
-         for (auto channel : range) {
-            float offset = 0;
-            float extent2 = 0;
-            bGoodResult =
-               AnalyseTrack( channel, msg, progress, offset, extent2 );
-            if ( ! bGoodResult )
-               goto break2;
-#ifdef EXPERIMENTAL_R128_NORM
-            if (mUseLoudness)
-               extent += extent2;
-            else
-#endif
-               extent = std::max( extent, extent2 );
-            offsets.push_back(offset);
-            // TODO: more-than-two-channels-message
-            msg = topMsg +
-               wxString::Format( _("Analyzing second track of stereo pair: %s"), trackName );
-         }
+         std::vector<const WaveTrack *> channels;
+         for (auto channel : range)
+            channels.push_back(channel);
+         bGoodResult = AnalyseChannels( channels,
+            topMsg + wxString::Format( _("Analyzing: %s"), trackName ),
+            progress, offsets, extent );
+         if ( ! bGoodResult )
+            goto break2;
 
          // Compute the multiplier using extent
          if( (extent > 0) && mGain ) {
@@ -312,6 +284,7 @@ bool EffectNormalize::Process()
          else
             mMult = 1.0;
 
+         wxString msg;
          if (range.size() == 1) {
             if (TrackList::Channels(track).size() == 1)
                // really mono
@@ -437,35 +410,145 @@ bool EffectNormalize::TransferDataFromWindow()
 
 // EffectNormalize implementation
 
-bool EffectNormalize::AnalyseTrack(const WaveTrack * track, const wxString &msg,
-                                   double &progress, float &offset, float &extent)
+namespace {
+
+// Everything that one channel contributes to the analysis, so that a single
+// read of its samples serves both the DC offset and the loudness
+struct ChannelAnalysis
 {
-   bool result = true;
-   float min, max;
+   void Analyse();
+
+   Floats buffer;
+   size_t len{ 0 };
+
+   double sum{ 0.0 };
+   sampleCount filled{ 0 };
 
-   if(mGain)
-   {
 #ifdef EXPERIMENTAL_R128_NORM
-      if(mUseLoudness)
-      {
-         CalcEBUR128HPF(track->GetRate());
-         CalcEBUR128HSF(track->GetRate());
-         if(mDC)
-         {
-            result = AnalyseTrackData(track, msg, progress, ANALYSE_LOUDNESS_DC, offset);
-         }
-         else
-         {
-            result = AnalyseTrackData(track, msg, progress, ANALYSE_LOUDNESS, offset);
-            offset = 0.0;
-         }
+   bool loudness{ false };
+   // The high shelf and then the high pass of the K-weighting
+   BiquadCascade kWeighting;
+   sampleCount count{ 0 };
+   double sqSum{ 0.0 };
+
+   // K-weighted square sums of consecutive 100ms gating steps
+   std::vector<double> stepSqSums;
+   size_t stepLen{ 0 };
+   size_t stepFill{ 0 };
+   double stepSqSum{ 0.0 };
+#endif
+};
 
-         // EBU R128: z_i = mean square without root
-         extent = mSqSum / mCount.as_double();
+void ChannelAnalysis::Analyse()
+{
+   float *data = buffer.get();
+
+   for (size_t i = 0; i < len; i++)
+      sum += (double)data[i];
+
+#ifdef EXPERIMENTAL_R128_NORM
+   if (loudness) {
+      // The buffer is not needed after this, so filter it in place
+      kWeighting.Process(&data, &data, len);
+
+      // Sum with local copies, which the compiler can then keep in
+      // registers instead of storing back for every sample
+      auto localSqSum = sqSum;
+      auto localStepSqSum = stepSqSum;
+      auto localStepFill = stepFill;
+      for (size_t i = 0; i < len; i++) {
+         const float value = data[i];
+         const double square = ((double)value) * ((double)value);
+         localSqSum += square;
+         localStepSqSum += square;
+         if (++localStepFill == stepLen) {
+            // Capacity was reserved in advance, so this does not throw
+            stepSqSums.push_back(localStepSqSum);
+            localStepSqSum = 0.0;
+            localStepFill = 0;
+         }
       }
-      else
-      {
+      sqSum = localSqSum;
+      stepSqSum = localStepSqSum;
+      stepFill = localStepFill;
+      count += len;
+   }
 #endif
+}
+
+#ifdef EXPERIMENTAL_R128_NORM
+// Integrated loudness as ITU-R BS.1770 defines it for EBU R128:  blocks of
+// 400ms overlapping by 75% are gated at -70 LUFS, then again at 10 LU below
+// the mean of the blocks that passed.  This works directly with the sum over
+// channels of the K-weighted mean squares, leaving out the logarithm and
+// the -0.691 dB offset.  A selection shorter than one block is not gated.
+double GatedMeanSquare(const std::vector<ChannelAnalysis> &analyses)
+{
+   enum : size_t { StepsPerBlock = 4 };
+
+   auto nSteps = analyses[0].stepSqSums.size();
+   for (const auto &analysis : analyses)
+      nSteps = std::min(nSteps, analysis.stepSqSums.size());
+
+   if (nSteps < StepsPerBlock) {
+      double total = 0.0;
+      for (const auto &analysis : analyses)
+         if (analysis.count > 0)
+            total += analysis.sqSum / analysis.count.as_double();
+      return total;
+   }
+
+   const double blockLen = StepsPerBlock * analyses[0].stepLen;
+   std::vector<double> blocks(nSteps - StepsPerBlock + 1);
+   for (size_t ii = 0; ii < blocks.size(); ++ii) {
+      double total = 0.0;
+      for (const auto &analysis : analyses)
+         for (size_t jj = 0; jj < StepsPerBlock; ++jj)
+            total += analysis.stepSqSums[ii + jj];
+      blocks[ii] = total / blockLen;
+   }
+
+   auto meanAbove = [&blocks](double gate) {
+      double total = 0.0;
+      size_t n = 0;
+      for (auto block : blocks)
+         if (block > gate)
+            total += block, ++n;
+      return n > 0 ? total / n : 0.0;
+   };
+
+   const double absoluteGate = pow(10.0, (-70.0 + 0.691) / 10.0);
+   const double relativeGate = meanAbove(absoluteGate) / 10.0;
+   return meanAbove(std::max(absoluteGate, relativeGate));
+}
+#endif
+
+}
+
+// AnalyseChannels() computes the DC offset of each of the channels, and the
+// extent that the multiplier is computed from:  the greatest peak of any
+// channel, or the loudness of all channels together.  The samples are read
+// just once, whichever of these are needed.
+bool EffectNormalize::AnalyseChannels(
+   const std::vector<const WaveTrack *> &channels, const wxString &msg,
+   double &progress, std::vector<float> &offsets, float &extent)
+{
+   bool rc = true;
+   const auto nChannels = channels.size();
+   offsets.assign(nChannels, 0.0);
+
+#ifdef EXPERIMENTAL_R128_NORM
+   const bool loudness = mGain && mUseLoudness;
+#else
+   const bool loudness = false;
+#endif
+
+   std::vector< std::pair<float, float> > minMax(
+      nChannels, { -1.0, 1.0 } );   // sensible defaults?
+   if (mGain && !loudness) {
+      for (size_t ii = 0; ii < nChannels; ++ii) {
+         const auto track = channels[ii];
+
          // Since we need complete summary data, we need to block until the OD tasks are done for this track
          // This is needed for track->GetMinMax
          // TODO: should we restrict the flags to just the relevant block files (for selections)
@@ -477,112 +560,102 @@ bool EffectNormalize::AnalyseTrack(const WaveTrack * track, const wxString &msg,
             wxMilliSleep(100);
          }
 
-         // set mMin, mMax.  No progress bar here as it's fast.
-         auto pair = track->GetMinMax(mCurT0, mCurT1); // may throw
-         min = pair.first, max = pair.second;
-
-         if(mDC)
-         {
-            result = AnalyseTrackData(track, msg, progress, ANALYSE_DC, offset);
-            min += offset;
-            max += offset;
-         }
-#ifdef EXPERIMENTAL_R128_NORM
+         // No progress bar here as it's fast.
+         minMax[ii] = track->GetMinMax(mCurT0, mCurT1); // may throw
       }
-#endif
-   }
-   else if(mDC)
-   {
-      min = -1.0, max = 1.0;   // sensible defaults?
-      result = AnalyseTrackData(track, msg, progress, ANALYSE_DC, offset);
-      min += offset;
-      max += offset;
    }
-   else
-   {
-      wxFAIL_MSG("Analysing Track when nothing to do!");
-      min = -1.0, max = 1.0;   // sensible defaults?
-      offset = 0.0;
-   }
-#ifdef EXPERIMENTAL_R128_NORM
-   if(!mUseLoudness)
-#endif
-      extent = fmax(fabs(min), fabs(max));
 
-   return result;
-}
+   if (mDC || loudness) {
+      //Transform the marker timepoints to samples.  Channels share the rate.
+      auto start = channels[0]->TimeToLongSamples(mCurT0);
+      auto end = channels[0]->TimeToLongSamples(mCurT1);
+      auto len = (end - start).as_double();
 
-//AnalyseTrackData() takes a track, transforms it to bunch of buffer-blocks,
-//and executes selected AnalyseOperation on it...
-bool EffectNormalize::AnalyseTrackData(const WaveTrack * track, const wxString &msg,
-                                double &progress, AnalyseOperation op, float &offset)
-{
-   bool rc = true;
+      size_t bufferSize = 0;
+      for (auto track : channels)
+         bufferSize = std::max(bufferSize, track->GetMaxBlockSize());
 
-   //Transform the marker timepoints to samples
-   auto start = track->TimeToLongSamples(mCurT0);
-   auto end = track->TimeToLongSamples(mCurT1);
-
-   //Get the length of the buffer (as double). len is
-   //used simply to calculate a progress meter, so it is easier
-   //to make it a double now than it is to do it later
-   auto len = (end - start).as_double();
+      std::vector<ChannelAnalysis> analyses(nChannels);
+      for (size_t ii = 0; ii < nChannels; ++ii) {
+         auto &analysis = analyses[ii];
+         analysis.buffer.reinit(bufferSize);
+#ifdef EXPERIMENTAL_R128_NORM
+         if (loudness) {
+            const auto rate = channels[ii]->GetRate();
+            CalcEBUR128HPF(rate);
+            CalcEBUR128HSF(rate);
+            analysis.loudness = true;
+            const Biquad sections[] = { mR128HSF, mR128HPF };
+            analysis.kWeighting.SetSections(sections, 2);
+            analysis.stepLen = std::max<size_t>(1, (size_t)rint(rate / 10.0));
+            analysis.stepSqSums.reserve(
+               (end - start).as_size_t() / analysis.stepLen + 1);
+         }
+#endif
+      }
 
-   //Initiate a processing buffer.  This buffer will (most likely)
-   //be shorter than the length of the track being processed.
-   Floats buffer{ track->GetMaxBlockSize() };
+      auto s = start;
+      while (s < end) {
+         const auto block = limitSampleBufferSize(
+            channels[0]->GetBestBlockSize(s),
+            end - s
+         );
+
+         for (size_t ii = 0; ii < nChannels; ++ii) {
+            auto &analysis = analyses[ii];
+            sampleCount blockSamples;
+            channels[ii]->Get((samplePtr) analysis.buffer.get(), floatSample,
+               s, block, fillZero, true, &blockSamples);
+            analysis.len = block;
+            analysis.filled += blockSamples;
+         }
 
-   mSum   = 0.0; // dc offset inits
-   mCount = 0;
 #ifdef EXPERIMENTAL_R128_NORM
-   mSqSum = 0.0; // rms init
+         // The K-weighting filters are recursive, but the channels are
+         // independent of one another, so they are filtered concurrently.
+         // Reading of the tracks stays on this thread.
+         if (loudness)
+            ParallelFor(nChannels, [&analyses](size_t ii) {
+               analyses[ii].Analyse();
+            } );
+         else
 #endif
+         for (auto &analysis : analyses)
+            analysis.Analyse();
 
-   sampleCount blockSamples;
-   sampleCount totalSamples = 0;
+         s += block;
 
-   //Go through the track one buffer at a time. s counts which
-   //sample the current buffer starts at.
-   auto s = start;
-   while (s < end) {
-      //Get a block of samples (smaller than the size of the buffer)
-      //Adjust the block size if it is the final block in the track
-      const auto block = limitSampleBufferSize(
-         track->GetBestBlockSize(s),
-         end - s
-      );
+         //Update the Progress meter
+         if (TotalProgress(progress + nChannels *
+                           ((s - start).as_double() / len)/double(2*GetNumWaveTracks()), msg)) {
+            rc = false;
+            break;
+         }
+      }
+      progress += nChannels/double(2*GetNumWaveTracks());
 
-      //Get the samples from the track and put them in the buffer
-      track->Get((samplePtr) buffer.get(), floatSample, s, block, fillZero, true, &blockSamples);
-      totalSamples += blockSamples;
+      // calculate actual offsets (amount that needs to be added on)
+      if (mDC)
+         for (size_t ii = 0; ii < nChannels; ++ii)
+            if (analyses[ii].filled > 0)
+               offsets[ii] =
+                  -analyses[ii].sum / analyses[ii].filled.as_double();
 
-      //Process the buffer.
-      if(op == ANALYSE_DC)
-         AnalyseDataDC(buffer.get(), block);
 #ifdef EXPERIMENTAL_R128_NORM
-      else if(op == ANALYSE_LOUDNESS)
-         AnalyseDataLoudness(buffer.get(), block);
-      else if(op == ANALYSE_LOUDNESS_DC)
-         AnalyseDataLoudnessDC(buffer.get(), block);
+      if (loudness)
+         // EBU R128: z_i = mean square without root
+         extent = GatedMeanSquare(analyses);
 #endif
+   }
 
-      //Increment s one blockfull of samples
-      s += block;
-
-      //Update the Progress meter
-      if (TotalProgress(progress +
-                        ((s - start).as_double() / len)/double(2*GetNumWaveTracks()), msg)) {
-         rc = false; //lda .. break, not return, so that buffer is deleted
-         break;
-      }
+   if (!loudness) {
+      extent = std::numeric_limits<float>::lowest();
+      for (size_t ii = 0; ii < nChannels; ++ii)
+         extent = std::max( extent, (float)fmax(
+            fabs(minMax[ii].first + offsets[ii]),
+            fabs(minMax[ii].second + offsets[ii])) );
    }
-   if( totalSamples > 0 )
-      offset = -mSum / totalSamples.as_double();  // calculate actual offset (amount that needs to be added on)
-   else
-      offset = 0.0;
 
-   progress += 1.0/double(2*GetNumWaveTracks());
-   //Return true because the effect processing succeeded ... unless cancelled
    return rc;
 }
 
@@ -644,48 +717,6 @@ bool EffectNormalize::ProcessOne(
    return rc;
 }
 
-/// @see AnalyseDataLoudnessDC
-void EffectNormalize::AnalyseDataDC(float *buffer, size_t len)
-{
-   for(decltype(len) i = 0; i < len; i++)
-      mSum += (double)buffer[i];
-   mCount += len;
-}
-
-#ifdef EXPERIMENTAL_R128_NORM
-/// @see AnalyseDataLoudnessDC
-void EffectNormalize::AnalyseDataLoudness(float *buffer, size_t len)
-{
-   float value;
-   for(decltype(len) i = 0; i < len; i++)
-   {
-      value = mR128HSF.ProcessOne(buffer[i]);
-      value = mR128HPF.ProcessOne(value);
-      mSqSum += ((double)value) * ((double)value);
-   }
-   mCount += len;
-}
-
-/// Calculates sample sum (for DC) and EBU R128 weighted square sum
-/// (for loudness). This function has variants which only calculate
-/// sum or square sum for performance improvements if only one of those
-/// values is required.
-/// @see AnalyseDataLoudness
-/// @see AnalyseDataDC
-void EffectNormalize::AnalyseDataLoudnessDC(float *buffer, size_t len)
-{
-   float value;
-   for(decltype(len) i = 0; i < len; i++)
-   {
-      mSum += (double)buffer[i];
-      value = mR128HSF.ProcessOne(buffer[i]);
-      value = mR128HPF.ProcessOne(value);
-      mSqSum += ((double)value) * ((double)value);
-   }
-   mCount += len;
-}
-#endif
-
 void EffectNormalize::ProcessData(float *buffer, size_t len, float offset)
 {
    for(decltype(len) i = 0; i < len; i++) {
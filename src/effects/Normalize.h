@@ -13,6 +13,7 @@
 #ifndef __AUDACITY_EFFECT_NORMALIZE__
 #define __AUDACITY_EFFECT_NORMALIZE__
 
+#include <vector>
 #include <wx/checkbox.h>
 #include <wx/event.h>
 #include <wx/stattext.h>
@@ -60,22 +61,11 @@ public:
 private:
    // EffectNormalize implementation
 
-   enum AnalyseOperation
-   {
-      ANALYSE_DC, ANALYSE_LOUDNESS, ANALYSE_LOUDNESS_DC
-   };
-
    bool ProcessOne(
       WaveTrack * t, const wxString &msg, double& progress, float offset);
-   bool AnalyseTrack(const WaveTrack * track, const wxString &msg,
-                     double &progress, float &offset, float &extent);
-   bool AnalyseTrackData(const WaveTrack * track, const wxString &msg, double &progress,
-                     AnalyseOperation op, float &offset);
-   void AnalyseDataDC(float *buffer, size_t len);
-#ifdef EXPERIMENTAL_R128_NORM
-   void AnalyseDataLoudness(float *buffer, size_t len);
-   void AnalyseDataLoudnessDC(float *buffer, size_t len);
-#endif
+   bool AnalyseChannels(const std::vector<const WaveTrack *> &channels,
+                        const wxString &msg, double &progress,
+                        std::vector<float> &offsets, float &extent);
    void ProcessData(float *buffer, size_t len, float offset);
 
 #ifdef EXPERIMENTAL_R128_NORM
@@ -100,11 +90,6 @@ private:
    double mCurT0;
    double mCurT1;
    float  mMult;
-   double mSum;
-#ifdef EXPERIMENTAL_R128_NORM
-   double mSqSum;
-#endif
-   sampleCount    mCount;
 
    wxCheckBox *mGainCheckBox;
    wxCheckBox *mDCCheckBox;
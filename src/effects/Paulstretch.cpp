@@ -18,6 +18,7 @@
 #include "Paulstretch.h"
 
 #include <algorithm>
+#include <random>
 
 #include <math.h>
 #include <float.h>
@@ -25,8 +26,10 @@
 #include <wx/intl.h>
 #include <wx/valgen.h>
 
+#include "../ParallelFor.h"
 #include "../ShuttleGui.h"
 #include "../FFT.h"
+#include "../RealFFTf.h"
 #include "../widgets/valnum.h"
 #include "../widgets/ErrorDialog.h"
 #include "../Prefs.h"
@@ -48,13 +51,29 @@ public:
    //in_bufsize is also a half of a FFT buffer (in samples)
    virtual ~PaulStretch();
 
-   void process(float *smps, size_t nsmps);
+   /// \brief FFT tables and scratch space, for the windows of one thread
+   struct Workspace
+   {
+      explicit Workspace(size_t poolsize);
+
+      HFFT hFFT;
+      Floats fft_buf, fft_freq;
+   };
+
+   // Computes the randomized window for the poolsize samples of pool.
+   // The phases depend only on seed, so windows may be computed
+   // concurrently and in any order.
+   void process_window(Workspace &workspace, const float *pool,
+      unsigned seed, float *result) const;
+
+   // Makes out_buf, overlapping a window with the window before it
+   void make_output(const float *window, const float *old_window);
 
    size_t get_nsamples();//how many samples are required to be added in the pool next time
    size_t get_nsamples_for_fill();//how many samples are required to be added for a complete buffer refill (at start of the song or after seek)
 
 private:
-   void process_spectrum(float *WXUNUSED(freq)) {};
+   void process_spectrum(float *WXUNUSED(freq)) const {};
 
    const float samplerate;
    const float rap;
@@ -64,18 +83,15 @@ public:
    const size_t out_bufsize;
    const Floats out_buf;
 
-private:
-   const Floats old_out_smp_buf;
-
 public:
    const size_t poolsize;//how many samples are inside the input_pool size (need to know how many samples to fill when seeking)
 
 private:
-   const Floats in_pool;//de marimea in_bufsize
-
    double remained_samples;//how many fraction of samples has remained (0..1)
 
-   const Floats fft_smps, fft_c, fft_s, fft_freq, fft_tmp;
+   // Hanning window of the pool, and the shapes of the overlap
+   const Floats window, fade;
+   const ArrayOf<double> envelope;
 };
 
 //
@@ -332,44 +348,83 @@ bool EffectPaulstretch::ProcessOne(WaveTrack *track,double t0,double t1,int coun
 
       PaulStretch stretch(amount, stretch_buf_size, track->GetRate());
 
-      auto nget = stretch.get_nsamples_for_fill();
-
-      auto bufsize = stretch.poolsize;
-      Floats buffer0{ bufsize };
-      float *bufferptr0 = buffer0.get();
-      bool first_time = true;
-
-      const auto fade_len = std::min<size_t>(100, bufsize / 2 - 1);
+      const auto poolsize = stretch.poolsize;
+      const auto fade_len = std::min<size_t>(100, poolsize / 2 - 1);
       bool cancelled = false;
 
-      {
-         Floats fade_track_smps{ fade_len };
-         decltype(len) s=0;
-
-         while (s < len) {
-            track->Get((samplePtr)bufferptr0, floatSample, start + s, nget);
-            stretch.process(buffer0.get(), nget);
+      // Windows are computed in batches, each thread taking a contiguous
+      // share of a batch, and the input of a batch is read all at once.
+      // Output is then made in order on this thread.
+      const size_t nThreads = ParallelForConcurrency();
+      const size_t perThread = std::max<size_t>(1, (1 << 18) / poolsize);
+      const size_t batchSize = perThread * nThreads;
+
+      std::vector<PaulStretch::Workspace> workspaces;
+      for (size_t ii = 0; ii < nThreads; ++ii)
+         workspaces.emplace_back(poolsize);
+
+      // Consecutive pools overlap or abut, so a batch reads no more than this
+      Floats input{ batchSize * poolsize };
+      // Slot 0 keeps the last window of the previous batch for overlap
+      Floats windows{ (batchSize + 1) * poolsize };
+      Floats fade_track_smps{ fade_len };
+
+      // Where the pool of each window of the batch ends, relative to start.
+      // The first two windows share a pool, and the first is computed only
+      // to overlap the second.
+      std::vector<sampleCount> ends;
+      sampleCount s = stretch.get_nsamples_for_fill();
+      size_t windowIndex = 0;
+      bool last = false;
+
+      while (!last) {
+         ends.clear();
+         while (ends.size() < batchSize && !last) {
+            const auto index = windowIndex + ends.size();
+            if (index >= 2)
+               s += stretch.get_nsamples();
+            ends.push_back(s);
+            last = (index >= 1 && s >= len);
+         }
+         const auto nWindows = ends.size();
+
+         const auto readStart = ends.front() - poolsize;
+         track->Get((samplePtr)input.get(), floatSample, start + readStart,
+            (ends.back() - readStart).as_size_t());
+
+         {
+            const auto share = (nWindows + nThreads - 1) / nThreads;
+            ParallelFor(nThreads, [&](size_t thread) {
+               const auto stop = std::min(nWindows, (thread + 1) * share);
+               for (auto ii = thread * share; ii < stop; ++ii)
+                  stretch.process_window(workspaces[thread],
+                     input.get() + (ends[ii] - poolsize - readStart).as_size_t(),
+                     windowIndex + ii,
+                     windows.get() + (ii + 1) * poolsize);
+            } );
+         }
 
-            if (first_time) {
-               stretch.process(buffer0.get(), 0);
-            };
+         for (size_t ii = 0; ii < nWindows; ++ii) {
+            const auto index = windowIndex + ii;
+            if (index == 0)
+               continue;
 
-            s += nget;
+            const float *window = windows.get() + (ii + 1) * poolsize;
+            stretch.make_output(window, window - poolsize);
 
-            if (first_time){//blend the the start of the selection
+            if (index == 1){//blend the the start of the selection
                track->Get((samplePtr)fade_track_smps.get(), floatSample, start, fade_len);
-               first_time = false;
                for (size_t i = 0; i < fade_len; i++){
                   float fi = (float)i / (float)fade_len;
                   stretch.out_buf[i] =
                      stretch.out_buf[i] * fi + (1.0 - fi) * fade_track_smps[i];
                }
             }
-            if (s >= len){//blend the end of the selection
+            if (last && ii + 1 == nWindows){//blend the end of the selection
                track->Get((samplePtr)fade_track_smps.get(), floatSample, end - fade_len, fade_len);
                for (size_t i = 0; i < fade_len; i++){
                   float fi = (float)i / (float)fade_len;
-                  auto i2 = bufsize / 2 - 1 - i;
+                  auto i2 = poolsize / 2 - 1 - i;
                   stretch.out_buf[i2] =
                      stretch.out_buf[i2] * fi + (1.0 - fi) *
                      fade_track_smps[fade_len - 1 - i];
@@ -377,14 +432,17 @@ bool EffectPaulstretch::ProcessOne(WaveTrack *track,double t0,double t1,int coun
             }
 
             outputTrack->Append((samplePtr)stretch.out_buf.get(), floatSample, stretch.out_bufsize);
+         }
 
-            nget = stretch.get_nsamples();
-            if (TrackProgress(count,
-               s.as_double() / len.as_double()
-            )) {
-               cancelled = true;
-               break;
-            }
+         std::copy(windows.get() + nWindows * poolsize,
+                   windows.get() + (nWindows + 1) * poolsize, windows.get());
+         windowIndex += nWindows;
+
+         if (TrackProgress(count,
+            s.as_double() / len.as_double()
+         )) {
+            cancelled = true;
+            break;
          }
       }
 
@@ -413,80 +471,73 @@ PaulStretch::PaulStretch(float rap_, size_t in_bufsize_, float samplerate_ )
    , in_bufsize { in_bufsize_ }
    , out_bufsize { std::max(size_t{ 8 }, in_bufsize) }
    , out_buf { out_bufsize }
-   , old_out_smp_buf { out_bufsize * 2, true }
    , poolsize { in_bufsize_ * 2 }
-   , in_pool { poolsize, true }
    , remained_samples { 0.0 }
-   , fft_smps { poolsize, true }
-   , fft_c { poolsize, true }
-   , fft_s { poolsize, true }
-   , fft_freq { poolsize, true }
-   , fft_tmp { poolsize }
+   , window { poolsize }
+   , fade { out_bufsize }
+   , envelope { out_bufsize }
 {
+   std::fill(window.get(), window.get() + poolsize, 1.0f);
+   WindowFunc(eWinFuncHanning, poolsize, window.get());
+
+   float tmp = 1.0 / (float) out_bufsize * M_PI;
+   float hinv_sqrt2 = 0.853553390593f;//(1.0+1.0/sqrt(2))*0.5;
+
+   for (size_t i = 0; i < out_bufsize; i++) {
+      fade[i] = (0.5 + 0.5 * cos(i * tmp));
+      envelope[i] = (hinv_sqrt2 - (1.0 - hinv_sqrt2) * cos(i * 2.0 * tmp));
+   }
 }
 
 PaulStretch::~PaulStretch()
 {
 }
 
-void PaulStretch::process(float *smps, size_t nsmps)
+PaulStretch::Workspace::Workspace(size_t poolsize)
+   : hFFT{ GetFFT(poolsize) }
+   , fft_buf{ poolsize }
+   , fft_freq{ poolsize / 2 }
 {
-   //add NEW samples to the pool
-   if ((smps != NULL) && (nsmps != 0)) {
-      if (nsmps > poolsize) {
-         nsmps = poolsize;
-      }
-      int nleft = poolsize - nsmps;
-
-      //move left the samples from the pool to make room for NEW samples
-      for (int i = 0; i < nleft; i++)
-         in_pool[i] = in_pool[i + nsmps];
+}
 
-      //add NEW samples to the pool
-      for (size_t i = 0; i < nsmps; i++)
-         in_pool[i + nleft] = smps[i];
-   }
+void PaulStretch::process_window(Workspace &workspace, const float *pool,
+   unsigned seed, float *result) const
+{
+   const auto hFFT = workspace.hFFT.get();
+   const auto fft_buf = workspace.fft_buf.get();
+   const auto fft_freq = workspace.fft_freq.get();
 
-   //get the samples from the pool
    for (size_t i = 0; i < poolsize; i++)
-      fft_smps[i] = in_pool[i];
-   WindowFunc(eWinFuncHanning, poolsize, fft_smps.get());
+      fft_buf[i] = pool[i] * window[i];
 
-   RealFFT(poolsize, fft_smps.get(), fft_c.get(), fft_s.get());
+   RealFFTf(fft_buf, hFFT);
 
-   for (size_t i = 0; i < poolsize / 2; i++)
-      fft_freq[i] = sqrt(fft_c[i] * fft_c[i] + fft_s[i] * fft_s[i]);
-   process_spectrum(fft_freq.get());
+   for (size_t i = 1; i < poolsize / 2; i++) {
+      const auto c = fft_buf[hFFT->BitReversed[i]];
+      const auto s = fft_buf[hFFT->BitReversed[i] + 1];
+      fft_freq[i] = sqrt(c * c + s * s);
+   }
+   process_spectrum(fft_freq);
 
 
    //put randomize phases to frequencies and do a IFFT
+   std::mt19937 random{ seed };
    float inv_2p15_2pi = 1.0 / 16384.0 * (float)M_PI;
    for (size_t i = 1; i < poolsize / 2; i++) {
-      unsigned int random = (rand()) & 0x7fff;
-      float phase = random * inv_2p15_2pi;
-      float s = fft_freq[i] * sin(phase);
-      float c = fft_freq[i] * cos(phase);
-
-      fft_c[i] = fft_c[poolsize - i] = c;
-
-      fft_s[i] = s; fft_s[poolsize - i] = -s;
+      unsigned int r = random() & 0x7fff;
+      float phase = r * inv_2p15_2pi;
+      fft_buf[2 * i] = fft_freq[i] * cos(phase);
+      fft_buf[2 * i + 1] = fft_freq[i] * sin(phase);
    }
-   fft_c[0] = fft_s[0] = 0.0;
-   fft_c[poolsize / 2] = fft_s[poolsize / 2] = 0.0;
+   // Zero the DC and Nyquist frequency bins
+   fft_buf[0] = fft_buf[1] = 0.0;
 
-   FFT(poolsize, true, fft_c.get(), fft_s.get(), fft_smps.get(), fft_tmp.get());
-
-   float max = 0.0, max2 = 0.0;
-   for (size_t i = 0; i < poolsize; i++) {
-      max = std::max(max, fabsf(fft_tmp[i]));
-      max2 = std::max(max2, fabsf(fft_smps[i]));
-   }
-
-
-   //make the output buffer
-   float tmp = 1.0 / (float) out_bufsize * M_PI;
-   float hinv_sqrt2 = 0.853553390593f;//(1.0+1.0/sqrt(2))*0.5;
+   InverseRealFFTf(fft_buf, hFFT);
+   ReorderToTime(hFFT, fft_buf, result);
+}
 
+void PaulStretch::make_output(const float *window, const float *old_window)
+{
    float ampfactor = 1.0;
    if (rap < 1.0)
       ampfactor = rap * 0.707;
@@ -494,16 +545,10 @@ void PaulStretch::process(float *smps, size_t nsmps)
       ampfactor = (out_bufsize / (float)poolsize) * 4.0;
 
    for (size_t i = 0; i < out_bufsize; i++) {
-      float a = (0.5 + 0.5 * cos(i * tmp));
-      float out = fft_smps[i + out_bufsize] * (1.0 - a) + old_out_smp_buf[i] * a;
-      out_buf[i] =
-         out * (hinv_sqrt2 - (1.0 - hinv_sqrt2) * cos(i * 2.0 * tmp)) *
-         ampfactor;
+      float a = fade[i];
+      float out = window[i + out_bufsize] * (1.0 - a) + old_window[i] * a;
+      out_buf[i] = out * envelope[i] * ampfactor;
    }
-
-   //copy the current output buffer to old buffer
-   for (size_t i = 0; i < out_bufsize * 2; i++)
-      old_out_smp_buf[i] = fft_smps[i];
 }
 
 size_t PaulStretch::get_nsamples()
@@ -17,10 +17,14 @@
 #include "../Audacity.h"
 #include "Reverb.h"
 
+#include <algorithm>
+#include <vector>
+
 #include <wx/arrstr.h>
 #include <wx/intl.h>
 
 #include "../Audacity.h"
+#include "../ParallelFor.h"
 #include "../Prefs.h"
 #include "../ShuttleGui.h"
 #include "../widgets/valnum.h"
@@ -126,6 +130,7 @@ EffectReverb::EffectReverb()
 
 EffectReverb::~EffectReverb()
 {
+   FreeReverbs();
 }
 
 // ComponentInterface implementation
@@ -166,16 +171,50 @@ unsigned EffectReverb::GetAudioOutCount()
 
 static size_t BLOCK = 16384;
 
+// True if reverbs made with the two settings are the same; the dry gain is
+// applied outside of them
+static bool SameReverb(const EffectReverb::Params &a, const EffectReverb::Params &b)
+{
+   return a.mRoomSize == b.mRoomSize &&
+      a.mPreDelay == b.mPreDelay &&
+      a.mReverberance == b.mReverberance &&
+      a.mHfDamping == b.mHfDamping &&
+      a.mToneLow == b.mToneLow &&
+      a.mToneHigh == b.mToneHigh &&
+      a.mWetGain == b.mWetGain &&
+      a.mStereoWidth == b.mStereoWidth;
+}
+
 bool EffectReverb::ProcessInitialize(sampleCount WXUNUSED(totalLen), ChannelNames chanMap)
 {
    bool isStereo = false;
-   mNumChans = 1;
+   unsigned numChans = 1;
    if (chanMap && chanMap[0] != ChannelNameEOL && chanMap[1] == ChannelNameFrontRight)
    {
       isStereo = true;
-      mNumChans = 2;
+      numChans = 2;
    }
 
+   // One application of the effect may process many tracks in turn.
+   // Clearing the reverbs of the last track is cheaper than making them
+   // again.
+   if (mP && numChans == mNumChans && mSampleRate == mReverbRate &&
+       SameReverb(mParams, mReverbParams))
+   {
+      for (unsigned int i = 0; i < mNumChans; i++)
+      {
+         reverb_clear(&mP[i].reverb);
+      }
+
+      return true;
+   }
+
+   FreeReverbs();
+
+   mNumChans = numChans;
+   mReverbRate = mSampleRate;
+   mReverbParams = mParams;
+
    mP = (Reverb_priv_t *) calloc(sizeof(*mP), mNumChans);
 
    for (unsigned int i = 0; i < mNumChans; i++)
@@ -199,14 +238,52 @@ bool EffectReverb::ProcessInitialize(sampleCount WXUNUSED(totalLen), ChannelName
 
 bool EffectReverb::ProcessFinalize()
 {
+   // The reverbs are kept for the next track, which may reuse them; End()
+   // frees them
+   return true;
+}
+
+void EffectReverb::ProcessReverbs(size_t len)
+{
+   // Each reverb makes a wet output for each output channel, and these depend
+   // only on its input.  In stereo there are four, which are made at once by
+   // the threads of the pool.
+   struct Wet {
+      reverb_t *reverb;
+      size_t chan;
+      const float *input;
+   };
+   std::vector<Wet> wets;
+   for (unsigned int c = 0; c < mNumChans; c++)
+   {
+      auto &reverb = mP[c].reverb;
+      const auto input = (const float *) fifo_read_ptr(&reverb.input_fifo);
+      for (size_t i = 0; i < 2 && reverb.out[i]; i++)
+         wets.push_back({ &reverb, i, input });
+   }
+
+   ParallelFor(wets.size(), [&wets, len](size_t ii) {
+      reverb_process_chan(wets[ii].reverb, wets[ii].chan, wets[ii].input, len);
+   } );
+
+   for (unsigned int c = 0; c < mNumChans; c++)
+   {
+      reverb_advance(&mP[c].reverb, len);
+   }
+}
+
+void EffectReverb::FreeReverbs()
+{
+   if (!mP)
+      return;
+
    for (unsigned int i = 0; i < mNumChans; i++)
    {
       reverb_delete(&mP[i].reverb);
    }
 
    free(mP);
-
-   return true;
+   mP = nullptr;
 }
 
 size_t EffectReverb::ProcessBlock(float **inBlock, float **outBlock, size_t blockLen)
@@ -232,8 +309,8 @@ size_t EffectReverb::ProcessBlock(float **inBlock, float **outBlock, size_t bloc
          // Write the input samples to the reverb fifo.  Returned value is the address of the
          // fifo buffer which contains a copy of the input samples.
          mP[c].dry = (float *) fifo_write(&mP[c].reverb.input_fifo, len, ichans[c]);
-         reverb_process(&mP[c].reverb, len);
       }
+      ProcessReverbs(len);
 
       if (mNumChans == 2)
       {
@@ -425,6 +502,11 @@ bool EffectReverb::Startup()
    return true;
 }
 
+void EffectReverb::End()
+{
+   FreeReverbs();
+}
+
 void EffectReverb::PopulateOrExchange(ShuttleGui & S)
 {
    S.AddSpace(0, 5);
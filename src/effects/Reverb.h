@@ -72,6 +72,7 @@ public:
    // Effect implementation
 
    bool Startup() override;
+   void End() override;
    void PopulateOrExchange(ShuttleGui & S) override;
    bool TransferDataToWindow() override;
    bool TransferDataFromWindow() override;
@@ -81,6 +82,9 @@ private:
 
    void SetTitle(const wxString & name = wxT(""));
 
+   void ProcessReverbs(size_t len);
+   void FreeReverbs();
+
 #define SpinSliderHandlers(n) \
    void On ## n ## Slider(wxCommandEvent & evt); \
    void On ## n ## Text(wxCommandEvent & evt);
@@ -99,7 +103,10 @@ private:
 
 private:
    unsigned mNumChans {};
-   Reverb_priv_t *mP;
+   Reverb_priv_t *mP {};
+   // The settings mP was made with
+   double mReverbRate {};
+   Params mReverbParams;
 
    Params mParams;
 
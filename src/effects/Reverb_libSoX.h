@@ -199,6 +199,26 @@ static void filter_array_process(filter_array_t * p,
    }
 }
 
+static void filter_array_clear(filter_array_t * p)
+{
+   size_t i;
+
+   for (i = 0; i < array_length(comb_lengths); ++i) {
+      filter_t * pcomb = &p->comb[i];
+      memset(pcomb->buffer, 0, pcomb->size * sizeof(float));
+      pcomb->ptr = pcomb->buffer;
+      pcomb->store = 0;
+   }
+   for (i = 0; i < array_length(allpass_lengths); ++i) {
+      filter_t * pallpass = &p->allpass[i];
+      memset(pallpass->buffer, 0, pallpass->size * sizeof(float));
+      pallpass->ptr = pallpass->buffer;
+      pallpass->store = 0;
+   }
+   for (i = 0; i < array_length(p->one_pole); ++i)
+      p->one_pole[i].i1 = p->one_pole[i].o1 = 0;
+}
+
 static void filter_array_delete(filter_array_t * p)
 {
    size_t i;
@@ -213,6 +233,7 @@ typedef struct {
    float feedback;
    float hf_damping;
    float gain;
+   size_t delay;
    fifo_t input_fifo;
    filter_array_t chan[2];
    float * out[2];
@@ -242,6 +263,7 @@ static void reverb_create(reverb_t * p, double sample_rate_Hz,
    p->feedback = 1 - exp((reverberance - b) / (a * b));
    p->hf_damping = hf_damping / 100 * .3 + .2;
    p->gain = dB_to_linear(wet_gain_dB) * .015;
+   p->delay = delay;
    fifo_create(&p->input_fifo, sizeof(float));
    memset(fifo_write(&p->input_fifo, delay, 0), 0, delay * sizeof(float));
    for (i = 0; i <= ceil(depth); ++i) {
@@ -250,11 +272,28 @@ static void reverb_create(reverb_t * p, double sample_rate_Hz,
    }
 }
 
-static void reverb_process(reverb_t * p, size_t length)
+/* Returns the reverb to the state reverb_create() left it in, so that it can
+ * be used again with the same settings */
+static void reverb_clear(reverb_t * p)
 {
    size_t i;
+   fifo_clear(&p->input_fifo);
+   memset(fifo_write(&p->input_fifo, p->delay, 0), 0, p->delay * sizeof(float));
    for (i = 0; i < 2 && p->out[i]; ++i)
-      filter_array_process(p->chan + i, length, (float *) fifo_read_ptr(&p->input_fifo), p->out[i], &p->feedback, &p->hf_damping, &p->gain);
+      filter_array_clear(p->chan + i);
+}
+
+/* Makes the wet output of one channel.  The channels depend only on the
+ * input they share, so they may be processed at once, on different threads.
+ * The input is fifo_read_ptr(&p->input_fifo); reverb_advance() consumes it
+ * once all channels are done. */
+static void reverb_process_chan(reverb_t * p, size_t chan, float const * input, size_t length)
+{
+   filter_array_process(p->chan + chan, length, input, p->out[chan], &p->feedback, &p->hf_damping, &p->gain);
+}
+
+static void reverb_advance(reverb_t * p, size_t length)
+{
    fifo_read(&p->input_fifo, length, NULL);
 }
 
@@ -205,34 +205,28 @@ EffectType EffectScienFilter::GetType()
 
 // EffectClientInterface implementation
 
+// Both channels of a stereo track are filtered together by the cascade
 unsigned EffectScienFilter::GetAudioInCount()
 {
-   return 1;
+   return 2;
 }
 
 unsigned EffectScienFilter::GetAudioOutCount()
 {
-   return 1;
+   return 2;
 }
 
 bool EffectScienFilter::ProcessInitialize(sampleCount WXUNUSED(totalLen), ChannelNames WXUNUSED(chanMap))
 {
-   for (int iPair = 0; iPair < (mOrder + 1) / 2; iPair++)
-      mpBiquad[iPair].Reset();
+   mCascade.SetSections(mpBiquad.get(), (mOrder + 1) / 2);
+   mCascade.SetChannels(GetAudioInCount());
 
    return true;
 }
 
 size_t EffectScienFilter::ProcessBlock(float **inBlock, float **outBlock, size_t blockLen)
 {
-   float *ibuf = inBlock[0];
-   for (int iPair = 0; iPair < (mOrder + 1) / 2; iPair++)
-   {
-      mpBiquad[iPair].pfIn = ibuf;
-      mpBiquad[iPair].pfOut = outBlock[0];
-      mpBiquad[iPair].Process(blockLen);
-      ibuf = outBlock[0];
-   }
+   mCascade.Process(inBlock, outBlock, blockLen);
 
    return blockLen;
 }
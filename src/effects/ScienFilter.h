@@ -103,6 +103,7 @@ private:
    int mOrder;
    int mOrderIndex;
    ArrayOf<Biquad> mpBiquad;
+   BiquadCascade mCascade;
 
    double mdBMax;
    double mdBMin;
@@ -16,9 +16,14 @@ effect that uses SoundTouch to do its processing (ChangeTempo
 
 #if USE_SOUNDTOUCH
 
+#include <algorithm>
+#include <cstdlib>
 #include <math.h>
+#include <vector>
 
 #include "../LabelTrack.h"
+#include "../ParallelFor.h"
+#include "../Prefs.h"
 #include "../WaveTrack.h"
 #include "../Project.h"
 #include "SoundTouchEffect.h"
@@ -68,11 +73,13 @@ bool EffectSoundTouch::ProcessNoteTrack(NoteTrack *nt, const TimeWarper &warper)
 }
 #endif
 
-bool EffectSoundTouch::ProcessWithTimeWarper(const TimeWarper &warper)
+bool EffectSoundTouch::ProcessWithTimeWarper(InitFunction initer,
+                                             const TimeWarper &warper)
 {
-   // Assumes that mSoundTouch has already been initialized
-   // by the subclass for subclass-specific parameters. The
-   // time warper should also be set.
+   // The initer sets the subclass-specific parameters of each SoundTouch
+   // instance.
+   mSoundTouch = std::make_unique<soundtouch::SoundTouch>();
+   initer(mSoundTouch.get());
 
    // Check if this effect will alter the selection length; if so, we need
    // to operate on sync-lock selected tracks.
@@ -89,6 +96,17 @@ bool EffectSoundTouch::ProcessWithTimeWarper(const TimeWarper &warper)
    mCurTrackNum = 0;
    m_maxNewLength = 0.0;
 
+   // Selections of at least two segments are split into overlapping
+   // segments, processed on as many threads as there are CPUs.  Thirty
+   // seconds keeps the crossfaded joins rare, and each segment long enough
+   // to be worth a thread of its own.  Setting the preference
+   // /Effects/SoundTouch/SegmentLength to zero runs one engine over the
+   // whole selection instead.
+   const double segmentLength =
+      gPrefs->Read(wxT("/Effects/SoundTouch/SegmentLength"), 30.0);
+   const double overlapLength = std::min(segmentLength / 2,
+      gPrefs->Read(wxT("/Effects/SoundTouch/SegmentOverlap"), 0.1));
+
    mOutputTracks->Leaders().VisitWhile( bGoodResult,
       [&]( LabelTrack *lt, const Track::Fallthrough &fallthrough ) {
          if ( !(lt->GetSelected() || (mustSync && lt->IsSyncLockSelected())) )
@@ -120,6 +138,9 @@ bool EffectSoundTouch::ProcessWithTimeWarper(const TimeWarper &warper)
          // Process only if the right marker is to the right of the left marker
          if (mCurT1 > mCurT0) {
 
+            const bool bySegments = ParallelForConcurrency() > 1 &&
+               segmentLength > 0 && mCurT1 - mCurT0 >= 2 * segmentLength;
+
             // TODO: more-than-two-channels
             auto channels = TrackList::Channels(leftTrack);
             if (auto rightTrack = * ++ channels.begin()) {
@@ -137,24 +158,38 @@ bool EffectSoundTouch::ProcessWithTimeWarper(const TimeWarper &warper)
                auto start = leftTrack->TimeToLongSamples(mCurT0);
                auto end = leftTrack->TimeToLongSamples(mCurT1);
 
-               //Inform soundtouch there's 2 channels
-               mSoundTouch->setChannels(2);
-
-               //ProcessStereo() (implemented below) processes a stereo track
-               if (!ProcessStereo(leftTrack, rightTrack, start, end, warper))
-                  bGoodResult = false;
+               if (bySegments) {
+                  if (!ProcessSegments(initer, leftTrack, rightTrack,
+                        start, end, warper, segmentLength, overlapLength))
+                     bGoodResult = false;
+               }
+               else {
+                  //Inform soundtouch there's 2 channels
+                  mSoundTouch->setChannels(2);
+
+                  //ProcessStereo() (implemented below) processes a stereo track
+                  if (!ProcessStereo(leftTrack, rightTrack, start, end, warper))
+                     bGoodResult = false;
+               }
                mCurTrackNum++; // Increment for rightTrack, too.
             } else {
                //Transform the marker timepoints to samples
                auto start = leftTrack->TimeToLongSamples(mCurT0);
                auto end = leftTrack->TimeToLongSamples(mCurT1);
 
-               //Inform soundtouch there's a single channel
-               mSoundTouch->setChannels(1);
-
-               //ProcessOne() (implemented below) processes a single track
-               if (!ProcessOne(leftTrack, start, end, warper))
-                  bGoodResult = false;
+               if (bySegments) {
+                  if (!ProcessSegments(initer, leftTrack, nullptr,
+                        start, end, warper, segmentLength, overlapLength))
+                     bGoodResult = false;
+               }
+               else {
+                  //Inform soundtouch there's a single channel
+                  mSoundTouch->setChannels(1);
+
+                  //ProcessOne() (implemented below) processes a single track
+                  if (!ProcessOne(leftTrack, start, end, warper))
+                     bGoodResult = false;
+               }
             }
          }
          mCurTrackNum++;
@@ -380,4 +415,209 @@ bool EffectSoundTouch::ProcessStereoResults(const size_t outputCount,
    return true;
 }
 
+bool EffectSoundTouch::ProcessSegments(const InitFunction &initer,
+   WaveTrack *leftTrack, WaveTrack *rightTrack,
+   sampleCount start, sampleCount end, const TimeWarper &warper,
+   double segmentLength, double overlapLength)
+{
+   const unsigned nChannels = rightTrack ? 2 : 1;
+   const double rate = leftTrack->GetRate();
+   const auto sampleRate = (unsigned int)(rate + 0.5);
+
+   // Each segment after the first also reads the overlap before it, which
+   // is crossfaded with the end of the previous segment's output
+   const auto segmentSamples =
+      std::max<size_t>(1, (size_t)(segmentLength * rate));
+   const auto overlapSamples = (size_t)(std::max(0.0, overlapLength) * rate);
+   // How far the joined outputs may be shifted to line them up.  Each
+   // shift lengthens or shortens the output; the sum of the shifts so far
+   // is kept within this bound, and taken back at the end, so the output
+   // has the length it would have without shifting.
+   const auto seekSamples = (size_t)(0.01 * rate);
+   long long drift = 0;
+
+   std::vector<WaveTrack *> tracks{ leftTrack };
+   if (rightTrack)
+      tracks.push_back(rightTrack);
+   std::vector<WaveTrack::Holder> outputTracks;
+   for (auto track : tracks)
+      outputTracks.push_back(
+         mFactory->NewWaveTrack(track->GetSampleFormat(), track->GetRate()));
+
+   struct Segment {
+      Floats input;   // interleaved
+      size_t inputLen;
+      size_t overlap; // leading input samples shared with the previous one
+      Floats output;  // interleaved
+      size_t outputLen;
+   };
+   std::vector<Segment> segments(ParallelForConcurrency());
+
+   auto processSegment = [&](size_t ii) {
+      auto &segment = segments[ii];
+      soundtouch::SoundTouch soundTouch;
+      initer(&soundTouch);
+      soundTouch.setChannels(nChannels);
+      soundTouch.setSampleRate(sampleRate);
+      soundTouch.putSamples(segment.input.get(), (unsigned int)segment.inputLen);
+      soundTouch.flush();
+      segment.outputLen = soundTouch.numSamples();
+      segment.output.reinit(segment.outputLen * nChannels);
+      soundTouch.receiveSamples(segment.output.get(), segment.outputLen);
+   };
+
+   auto append = [&](const float *buffer, size_t len) {
+      for (unsigned iChannel = 0; iChannel < nChannels; ++iChannel)
+         outputTracks[iChannel]->Append((samplePtr)(buffer + iChannel),
+            floatSample, len, nChannels);
+   };
+
+   Floats buffer{ leftTrack->GetMaxBlockSize() };
+
+   // The end of the latest output, held back for the next crossfade
+   std::vector<float> held;
+
+   const double len = (end - start).as_double();
+   auto s = start;
+   while (s < end) {
+      // Read a segment for each thread, here on the main thread
+      size_t nSegments = 0;
+      for (; nSegments < segments.size() && s < end; ++nSegments) {
+         auto &segment = segments[nSegments];
+         segment.overlap = (s == start)
+            ? 0 : limitSampleBufferSize(overlapSamples, s - start);
+         const auto segmentStart = s - segment.overlap;
+         segment.inputLen = segment.overlap +
+            limitSampleBufferSize(segmentSamples, end - s);
+         segment.input.reinit(segment.inputLen * nChannels);
+
+         for (unsigned iChannel = 0; iChannel < nChannels; ++iChannel) {
+            size_t done = 0;
+            while (done < segment.inputLen) {
+               const auto pos = segmentStart + done;
+               const auto block = limitSampleBufferSize(
+                  tracks[iChannel]->GetBestBlockSize(pos),
+                  segment.inputLen - done);
+               tracks[iChannel]->Get(
+                  (samplePtr)buffer.get(), floatSample, pos, block);
+               for (size_t i = 0; i < block; ++i)
+                  segment.input[(done + i) * nChannels + iChannel] = buffer[i];
+               done += block;
+            }
+         }
+         s = segmentStart + segment.inputLen;
+      }
+
+      ParallelFor(nSegments, processSegment);
+
+      // Join the outputs in order
+      for (size_t ii = 0; ii < nSegments; ++ii) {
+         auto &segment = segments[ii];
+         auto output = segment.output.get();
+         auto outputLen = segment.outputLen;
+         const auto heldLen = held.size() / nChannels;
+         const auto overlapLen = std::min(heldLen, outputLen);
+
+         // The segments are not stretched in step with each other, so first
+         // find the shift, of either one against the other, at which their
+         // overlapping outputs best correlate; otherwise the crossfade may
+         // cancel in places
+         const auto maxShift = std::min(seekSamples, overlapLen / 2);
+         const auto fadeLen = overlapLen - maxShift;
+         size_t heldShift = 0, outputShift = 0;
+         const auto allowed = [&](long long shift)
+            { return std::abs(drift + shift) <= (long long)seekSamples; };
+         if (maxShift > 0) {
+            auto correlate = [&](size_t heldOffset, size_t outputOffset) {
+               const auto pHeld = held.data() + heldOffset * nChannels;
+               const auto pOutput = output + outputOffset * nChannels;
+               double product = 0, energy = 0;
+               for (size_t i = 0; i < fadeLen * nChannels; ++i) {
+                  product += pHeld[i] * pOutput[i];
+                  energy += pOutput[i] * pOutput[i];
+               }
+               return product / sqrt(energy + 1e-12);
+            };
+            auto best = correlate(0, 0);
+            for (size_t shift = 1; shift <= maxShift; ++shift) {
+               if (allowed(shift)) {
+                  auto value = correlate(shift, 0);
+                  if (value > best)
+                     best = value, heldShift = shift, outputShift = 0;
+               }
+               if (allowed(-(long long)shift)) {
+                  auto value = correlate(0, shift);
+                  if (value > best)
+                     best = value, heldShift = 0, outputShift = shift;
+               }
+            }
+         }
+         drift += (long long)heldShift - (long long)outputShift;
+
+         if (heldShift > 0)
+            append(held.data(), heldShift);
+         output += outputShift * nChannels;
+         outputLen -= outputShift;
+         for (size_t i = 0; i < fadeLen; ++i) {
+            const float gain = (i + 0.5f) / fadeLen;
+            for (unsigned iChannel = 0; iChannel < nChannels; ++iChannel) {
+               auto &sample = output[i * nChannels + iChannel];
+               sample = gain * sample +
+                  (1.0f - gain) * held[(heldShift + i) * nChannels + iChannel];
+            }
+         }
+         // Whatever was held beyond the crossfade covers the same time as
+         // the start of this output, so it is dropped
+         held.clear();
+
+         // Hold back as much as the next segment's overlap should become
+         const size_t toHold = (s < end || ii + 1 < nSegments)
+            ? std::min(outputLen, (size_t)(overlapSamples *
+               (double)segment.outputLen / segment.inputLen + 0.5))
+            : 0;
+         auto toAppend = outputLen - toHold;
+         if (toHold == 0) {
+            // The last output:  take back the drift, dropping or adding
+            // samples at the very end
+            if (drift > 0)
+               toAppend -= std::min((size_t)drift, toAppend);
+            else if (drift < 0) {
+               append(output, toAppend);
+               output += toAppend * nChannels;
+               toAppend = 0;
+               const std::vector<float> silence(-drift * nChannels);
+               append(silence.data(), -drift);
+            }
+            drift = 0;
+            append(output, toAppend);
+         }
+         else {
+            append(output, toAppend);
+            held.assign(output + toAppend * nChannels,
+                        output + outputLen * nChannels);
+         }
+
+         segment.input.reset();
+         segment.output.reset();
+      }
+
+      if (TrackProgress(mCurTrackNum, (s - start).as_double() / len))
+         return false;
+   }
+
+   for (auto &outputTrack : outputTracks)
+      outputTrack->Flush();
+
+   // Take the output tracks and insert in place of the original
+   // sample data
+   for (size_t iChannel = 0; iChannel < tracks.size(); ++iChannel) {
+      tracks[iChannel]->ClearAndPaste(
+         mCurT0, mCurT1, outputTracks[iChannel].get(), true, false, &warper);
+      m_maxNewLength =
+         wxMax(m_maxNewLength, outputTracks[iChannel]->GetEndTime());
+   }
+
+   return true;
+}
+
 #endif // USE_SOUNDTOUCH
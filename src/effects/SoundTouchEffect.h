@@ -21,6 +21,8 @@
 
 #include "Effect.h"
 
+#include <functional>
+
 // forward declaration of a class defined in SoundTouch.h
 // which is not included here
 namespace soundtouch { class SoundTouch; }
@@ -48,7 +50,9 @@ public:
 protected:
    // Effect implementation
 
-   bool ProcessWithTimeWarper(const TimeWarper &warper);
+   // Sets the subclass-specific parameters of each SoundTouch instance
+   using InitFunction = std::function< void(soundtouch::SoundTouch *soundtouch) >;
+   bool ProcessWithTimeWarper(InitFunction initer, const TimeWarper &warper);
 
    std::unique_ptr<soundtouch::SoundTouch> mSoundTouch;
    double mCurT0;
@@ -68,6 +72,13 @@ private:
    bool ProcessStereoResults(const size_t outputCount,
                               WaveTrack* outputLeftTrack,
                               WaveTrack* outputRightTrack);
+   // Long selections are split into overlapping segments, each processed by
+   // its own SoundTouch instance on a worker thread, and crossfaded together
+   bool ProcessSegments(const InitFunction &initer,
+                        WaveTrack *leftTrack, WaveTrack *rightTrack,
+                        sampleCount start, sampleCount end,
+                        const TimeWarper &warper,
+                        double segmentLength, double overlapLength);
 
    int    mCurTrackNum;
 
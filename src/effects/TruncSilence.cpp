@@ -609,8 +609,53 @@ bool EffectTruncSilence::Analyze(RegionList& silenceList,
    // Keep position in overall silences list for optimization
    RegionList::iterator rit(silenceList.begin());
 
-   // Allocate buffer
-   Floats buffer{ blockLen };
+   // Account for one sample; return false if the length of the preview
+   // has been reached
+   auto analyzeSample = [&](sampleCount position, float value) -> bool {
+      if (inputLength && ((outLength >= previewLen) || (outLength > wt->TimeToLongSamples(*minInputLength)))) {
+         *inputLength = wt->LongSamplesToTime(position) - wt->LongSamplesToTime(start);
+         return false;
+      }
+
+      if (fabs(value) < truncDbSilenceThreshold) {
+         (*silentFrame)++;
+      }
+      else {
+         sampleCount allowed = 0;
+         if (*silentFrame >= minSilenceFrames) {
+            if (inputLength) {
+               switch (mActionIndex) {
+                  case kTruncate:
+                     outLength += wt->TimeToLongSamples(mTruncLongestAllowedSilence);
+                     break;
+                  case kCompress:
+                     allowed = wt->TimeToLongSamples(mInitialAllowedSilence);
+                     outLength += sampleCount(
+                        allowed.as_double() +
+                           (*silentFrame - allowed).as_double()
+                              * mSilenceCompressPercent / 100.0
+                     );
+                     break;
+                  // default: // Not currently used.
+               }
+            }
+
+            // Record the silent region
+            trackSilences.push_back(Region(
+               wt->LongSamplesToTime(position - *silentFrame),
+               wt->LongSamplesToTime(position)
+            ));
+         }
+         else if (inputLength) {   // included as part of non-silence
+            outLength += *silentFrame;
+         }
+         *silentFrame = 0;
+         if (inputLength) {
+            ++outLength;   // Add non-silent sample to outLength
+         }
+      }
+      return true;
+   };
 
    // Loop through current track
    while (*index < end) {
@@ -677,54 +722,28 @@ bool EffectTruncSilence::Analyze(RegionList& silenceList,
       // Limit size of current block if we've reached the end
       auto count = limitSampleBufferSize( blockLen, end - *index );
 
-      // Fill buffer
-      wt->Get((samplePtr)(buffer.get()), floatSample, *index, count);
-
-      // Look for silenceList in current block
-      for (decltype(count) i = 0; i < count; ++i) {
-         if (inputLength && ((outLength >= previewLen) || (outLength > wt->TimeToLongSamples(*minInputLength)))) {
-            *inputLength = wt->LongSamplesToTime(*index + i) - wt->LongSamplesToTime(start);
-            break;
-         }
-
-         if (fabs(buffer[i]) < truncDbSilenceThreshold) {
-            (*silentFrame)++;
-         }
-         else {
-            sampleCount allowed = 0;
-            if (*silentFrame >= minSilenceFrames) {
-               if (inputLength) {
-                  switch (mActionIndex) {
-                     case kTruncate:
-                        outLength += wt->TimeToLongSamples(mTruncLongestAllowedSilence);
-                        break;
-                     case kCompress:
-                        allowed = wt->TimeToLongSamples(mInitialAllowedSilence);
-                        outLength += sampleCount(
-                           allowed.as_double() +
-                              (*silentFrame - allowed).as_double()
-                                 * mSilenceCompressPercent / 100.0
-                        );
-                        break;
-                     // default: // Not currently used.
-                  }
-               }
-
-               // Record the silent region
-               trackSilences.push_back(Region(
-                  wt->LongSamplesToTime(*index + i - *silentFrame),
-                  wt->LongSamplesToTime(*index + i)
-               ));
-            }
-            else if (inputLength) {   // included as part of non-silence
-               outLength += *silentFrame;
-            }
-            *silentFrame = 0;
-            if (inputLength) {
-                ++outLength;   // Add non-silent sample to outLength
+      // Look for silenceList in current block.  The block summaries show
+      // most silent stretches without reading their samples.
+      wt->ScanWithSummaries(*index, count,
+         [=](float min, float max) {
+            return max < truncDbSilenceThreshold &&
+               -min < truncDbSilenceThreshold;
+         },
+         [&](sampleCount runStart, sampleCount runLen, const float *samples) {
+            if (samples) {
+               for (size_t i = 0, n = runLen.as_size_t(); i < n; ++i)
+                  if (!analyzeSample(runStart + i, samples[i]))
+                     return false;
+               return true;
             }
-         }
-      }
+            // A silent run leaves outLength alone, so only its first
+            // sample can reach the end of the preview
+            if (!analyzeSample(runStart, 0.0f))
+               return false;
+            *silentFrame += runLen - 1;
+            return true;
+         });
+
       // Next block
       *index += count;
    }
@@ -49,6 +49,7 @@
 #include <wx/dcmemory.h>
 #include <wx/image.h>
 #include <wx/intl.h>
+#include <wx/log.h>
 #include <wx/menu.h>
 #include <wx/settings.h>
 #include <wx/textdlg.h>
@@ -115,7 +116,6 @@ wxString MeterUpdateMsg::toStringIfClipped()
 MeterUpdateQueue::MeterUpdateQueue(size_t maxLen):
    mBufferSize(maxLen)
 {
-   Clear();
 }
 
 // destructor
@@ -123,29 +123,35 @@ MeterUpdateQueue::~MeterUpdateQueue()
 {
 }
 
+// Discard all waiting messages.  Only the reader changes mStart, so
+// this is safe while the writer is still putting.
 void MeterUpdateQueue::Clear()
 {
-   mStart = 0;
-   mEnd = 0;
+   mStart.store(mEnd.load(std::memory_order_acquire),
+                std::memory_order_release);
 }
 
 // Add a message to the end of the queue.  Return false if the
 // queue was full.
 bool MeterUpdateQueue::Put(MeterUpdateMsg &msg)
 {
+   auto start = mStart.load(std::memory_order_acquire);
+   auto end = mEnd.load(std::memory_order_relaxed);
    // mStart can be greater than mEnd because it is all mod mBufferSize
-   wxASSERT( (mEnd + mBufferSize - mStart) >= 0 );
-   int len = (mEnd + mBufferSize - mStart) % mBufferSize;
+   auto len = (end + mBufferSize - start) % mBufferSize;
 
    // Never completely fill the queue, because then the
    // state is ambiguous (mStart==mEnd)
-   if (len + 1 >= (int)(mBufferSize))
+   if (len + 1 >= mBufferSize) {
+      mDropped.fetch_add(1, std::memory_order_relaxed);
       return false;
+   }
 
    //wxLogDebug(wxT("Put: %s"), msg.toString());
 
-   mBuffer[mEnd] = msg;
-   mEnd = (mEnd+1)%mBufferSize;
+   mBuffer[end] = msg;
+   // Publish the message only after it is written
+   mEnd.store((end+1)%mBufferSize, std::memory_order_release);
 
    return true;
 }
@@ -154,17 +160,25 @@ bool MeterUpdateQueue::Put(MeterUpdateMsg &msg)
 // Return false if the queue was empty.
 bool MeterUpdateQueue::Get(MeterUpdateMsg &msg)
 {
-   int len = (mEnd + mBufferSize - mStart) % mBufferSize;
+   auto start = mStart.load(std::memory_order_relaxed);
+   auto end = mEnd.load(std::memory_order_acquire);
+   auto len = (end + mBufferSize - start) % mBufferSize;
 
    if (len == 0)
       return false;
 
-   msg = mBuffer[mStart];
-   mStart = (mStart+1)%mBufferSize;
+   msg = mBuffer[start];
+   // Free the slot only after it is read
+   mStart.store((start+1)%mBufferSize, std::memory_order_release);
 
    return true;
 }
 
+unsigned MeterUpdateQueue::TakeDropped()
+{
+   return mDropped.exchange(0, std::memory_order_relaxed);
+}
+
 //
 // MeterPanel class
 //
@@ -884,25 +898,39 @@ static float ToDB(float v, float range)
    return ClipZeroToOne((db + range) / range);
 }
 
+// This is called from the audio thread, so it does as little as it can:
+// one tight pass over each channel for the peak and the sum of squares.
+// Decay, smoothing and peak hold are left to OnMeterUpdate.
 void MeterPanel::UpdateDisplay(unsigned numChannels, int numFrames, float *sampleData)
 {
-   float *sptr = sampleData;
    auto num = std::min(numChannels, mNumBars);
    MeterUpdateMsg msg;
 
    memset(&msg, 0, sizeof(msg));
    msg.numFrames = numFrames;
 
-   for(int i=0; i<numFrames; i++) {
-      for(unsigned int j=0; j<num; j++) {
-         msg.peak[j] = floatMax(msg.peak[j], fabs(sptr[j]));
-         msg.rms[j] += sptr[j]*sptr[j];
-
-         // In addition to looking for mNumPeakSamplesToClip peaked
-         // samples in a row, also send the number of peaked samples
-         // at the head and tail, in case there's a run of peaked samples
-         // that crosses block boundaries
-         if (fabs(sptr[j])>=MAX_AUDIO) {
+   for(unsigned int j=0; j<num; j++) {
+      const float *sptr = sampleData + j;
+      float peak = 0.0f;
+      float sumOfSquares = 0.0f;
+      for(int i=0; i<numFrames; i++, sptr += numChannels) {
+         peak = floatMax(peak, fabs(*sptr));
+         sumOfSquares += *sptr * *sptr;
+      }
+      msg.peak[j] = peak;
+      msg.rms[j] = sumOfSquares;
+
+      // Only a channel that reached full scale can have clipped
+      if (peak < MAX_AUDIO)
+         continue;
+
+      // In addition to looking for mNumPeakSamplesToClip peaked
+      // samples in a row, also send the number of peaked samples
+      // at the head and tail, in case there's a run of peaked samples
+      // that crosses block boundaries
+      sptr = sampleData + j;
+      for(int i=0; i<numFrames; i++, sptr += numChannels) {
+         if (fabs(*sptr)>=MAX_AUDIO) {
             if (msg.headPeakCount[j]==i)
                msg.headPeakCount[j]++;
             msg.tailPeakCount[j]++;
@@ -912,7 +940,6 @@ void MeterPanel::UpdateDisplay(unsigned numChannels, int numFrames, float *sampl
          else
             msg.tailPeakCount[j] = 0;
       }
-      sptr += numChannels;
    }
    for(unsigned int j=0; j<mNumBars; j++)
       msg.rms[j] = sqrt(msg.rms[j]/numFrames);
@@ -1050,6 +1077,14 @@ void MeterPanel::OnMeterUpdate(wxTimerEvent & WXUNUSED(event))
       }
    } // while
 
+   // The bars missed some audio if the queue overflowed, which happens only
+   // when this timer is held up, so this is logged once for each hold up
+   if (auto dropped = mQueue.TakeDropped())
+      wxLogMessage(mIsInput
+         ? _("Recording meter dropped %u updates")
+         : _("Playback meter dropped %u updates"),
+         dropped);
+
    if (numChanges > 0) {
       #ifdef EXPERIMENTAL_AUTOMATED_INPUT_LEVEL_ADJUSTMENT
          if (gAudioIO->AILAIsActive() && mIsInput && !discarded) {
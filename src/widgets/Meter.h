@@ -16,6 +16,7 @@
 #ifndef __AUDACITY_METER__
 #define __AUDACITY_METER__
 
+#include <atomic>
 #include <wx/brush.h>
 #include <wx/defs.h>
 #include <wx/gdicmn.h>
@@ -74,21 +75,39 @@ class MeterUpdateMsg
    wxString toStringIfClipped();
 };
 
-// Thread-safe queue of update messages
+// Queue of update messages from the audio thread to the main thread.
+// It takes no locks, and is safe for one writer and one reader.
 class MeterUpdateQueue
 {
  public:
    explicit MeterUpdateQueue(size_t maxLen);
    ~MeterUpdateQueue();
 
+   //
+   // For the writer only:
+   //
+
    bool Put(MeterUpdateMsg &msg);
+
+   //
+   // For the reader only:
+   //
+
    bool Get(MeterUpdateMsg &msg);
 
    void Clear();
 
+   // Number of messages that Put found no room for, since the last call
+   unsigned TakeDropped();
+
  private:
-   int              mStart;
-   int              mEnd;
+   enum : size_t { CacheLine = 64 };
+
+   // Align the two atomics to avoid false sharing
+   alignas(CacheLine) std::atomic<size_t> mStart{ 0 };
+   alignas(CacheLine) std::atomic<size_t> mEnd{ 0 };
+   std::atomic<unsigned> mDropped{ 0 };
+
    size_t           mBufferSize;
    ArrayOf<MeterUpdateMsg> mBuffer{mBufferSize};
 };